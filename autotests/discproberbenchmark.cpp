@@ -0,0 +1,297 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QtEndian>
+
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "discprober.h"
+
+class DiscProberBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testProbe_data();
+    void testProbe();
+    void benchmarkProbe_data();
+    void benchmarkProbe();
+    void benchmarkLegacyProbe();
+
+private:
+    QTemporaryDir m_dir;
+    QByteArray m_isoImage;
+    QByteArray m_udfImage;
+    QByteArray m_dataImage;
+};
+
+QTEST_GUILESS_MAIN(DiscProberBenchmark)
+
+static const int s_sectorSize = 2048;
+// directories in the root of the images, before the one telling the content
+static const int s_directoryCount = 2000;
+
+static void put16(QByteArray &image, qsizetype offset, quint16 value)
+{
+    qToLittleEndian(value, image.data() + offset);
+}
+
+static void put32(QByteArray &image, qsizetype offset, quint32 value)
+{
+    qToLittleEndian(value, image.data() + offset);
+}
+
+static void putDescriptor(QByteArray &image, int sector, char type, const char *identifier)
+{
+    image[sector * s_sectorSize] = type;
+    image.replace(sector * s_sectorSize + 1, 5, identifier);
+    image[sector * s_sectorSize + 6] = 1;
+}
+
+// An ISO 9660 filesystem whose path table lists the directories of the root
+static QByteArray iso9660Image(const QByteArrayList &directories)
+{
+    const int tableSector = 20;
+
+    QByteArray table;
+    QByteArrayList names = directories;
+    names.prepend(QByteArray(1, '\0')); // the root directory
+    for (const QByteArray &name : std::as_const(names)) {
+        QByteArray record(8, '\0');
+        record[0] = char(name.size());
+        put16(record, 6, 1);
+        record += name;
+        if (name.size() % 2) {
+            record += '\0';
+        }
+        table += record;
+    }
+
+    QByteArray image((tableSector + table.size() / s_sectorSize + 1) * s_sectorSize, '\0');
+    putDescriptor(image, 16, 1, "CD001");
+    put16(image, 16 * s_sectorSize + 128, s_sectorSize);
+    put32(image, 16 * s_sectorSize + 132, table.size());
+    put32(image, 16 * s_sectorSize + 140, tableSector);
+    putDescriptor(image, 17, char(255), "CD001");
+    image.replace(tableSector * s_sectorSize, table.size(), table);
+    return image;
+}
+
+// A UDF filesystem, without ISO 9660 bridge, whose root directory holds the directories
+static QByteArray udfImage(const QByteArrayList &directories)
+{
+    const int sequenceSector = 32;
+    const int partitionSector = 64;
+
+    QByteArray directory;
+    QByteArrayList names = directories;
+    names.prepend(QByteArray()); // the parent directory
+    for (const QByteArray &name : std::as_const(names)) {
+        QByteArray identifier(38, '\0');
+        put16(identifier, 0, 257);
+        identifier[18] = name.isEmpty() ? 0x0a : 0x02;
+        if (!name.isEmpty()) {
+            identifier[19] = char(name.size() + 1);
+            identifier += char(8) + name;
+        }
+        identifier.append((4 - identifier.size() % 4) % 4, '\0');
+        directory += identifier;
+    }
+
+    QByteArray image((partitionSector + 2 + directory.size() / s_sectorSize + 1) * s_sectorSize, '\0');
+    putDescriptor(image, 16, 0, "BEA01");
+    putDescriptor(image, 17, 0, "NSR02");
+    putDescriptor(image, 18, 0, "TEA01");
+
+    // Anchor, pointing to the volume descriptor sequence
+    put16(image, 256 * s_sectorSize, 2);
+    put32(image, 256 * s_sectorSize + 16, 3 * s_sectorSize);
+    put32(image, 256 * s_sectorSize + 20, sequenceSector);
+
+    // Partition descriptor
+    const int partition = sequenceSector * s_sectorSize;
+    put16(image, partition, 5);
+    put16(image, partition + 22, 0);
+    put32(image, partition + 188, partitionSector);
+
+    // Logical volume descriptor, with the file set in block 0 and a single partition map
+    const int logicalVolume = (sequenceSector + 1) * s_sectorSize;
+    put16(image, logicalVolume, 6);
+    put32(image, logicalVolume + 212, s_sectorSize);
+    put32(image, logicalVolume + 248, s_sectorSize);
+    put32(image, logicalVolume + 252, 0);
+    put32(image, logicalVolume + 264, 6);
+    put32(image, logicalVolume + 268, 1);
+    image[logicalVolume + 440] = 1;
+    image[logicalVolume + 441] = 6;
+    put16(image, logicalVolume + 442, 1);
+    put16(image, logicalVolume + 444, 0);
+
+    put16(image, (sequenceSector + 2) * s_sectorSize, 8);
+
+    // File set descriptor, with the root directory entry in block 1
+    const int fileSet = partitionSector * s_sectorSize;
+    put16(image, fileSet, 256);
+    put32(image, fileSet + 400, s_sectorSize);
+    put32(image, fileSet + 404, 1);
+
+    // Root directory entry, with its content in block 2
+    const int fileEntry = (partitionSector + 1) * s_sectorSize;
+    put16(image, fileEntry, 261);
+    put32(image, fileEntry + 172, 8);
+    put32(image, fileEntry + 176, directory.size());
+    put32(image, fileEntry + 180, 2);
+
+    image.replace((partitionSector + 2) * s_sectorSize, directory.size(), directory);
+    return image;
+}
+
+// The prober this one replaces, reading the path table field by field
+static Solid::OpticalDisc::ContentType legacyDiscDetect(const QByteArray &device_file)
+{
+    unsigned short bs;
+    unsigned short ts;
+    unsigned int tl;
+    unsigned char len_di = 0;
+    unsigned int parent = 0;
+    char dirname[256];
+    int pos = 0;
+
+    Solid::OpticalDisc::ContentType result = Solid::OpticalDisc::NoContent;
+
+    int fd = open(device_file.constData(), O_RDONLY);
+
+    lseek(fd, 0x8080, SEEK_CUR);
+    if (read(fd, &bs, 2) != 2) {
+        close(fd);
+        return result;
+    }
+    lseek(fd, 2, SEEK_CUR);
+    if (read(fd, &ts, 2) != 2) {
+        close(fd);
+        return result;
+    }
+    lseek(fd, 6, SEEK_CUR);
+    if (read(fd, &tl, 4) != 4) {
+        close(fd);
+        return result;
+    }
+
+    lseek(fd, bs * tl, SEEK_SET);
+    while (pos < ts) {
+        if (read(fd, &len_di, 1) != 1) {
+            break;
+        }
+        lseek(fd, 5, SEEK_CUR);
+        if (read(fd, &parent, 2) != 2) {
+            break;
+        }
+        if (read(fd, dirname, len_di) != len_di) {
+            break;
+        }
+        dirname[len_di] = 0;
+
+        if (parent == 1) {
+            if (!strcasecmp(dirname, "VIDEO_TS")) {
+                result = Solid::OpticalDisc::VideoDvd;
+                break;
+            } else if (!strcasecmp(dirname, "BDMV")) {
+                result = Solid::OpticalDisc::VideoBluRay;
+                break;
+            } else if (!strcasecmp(dirname, "VCD")) {
+                result = Solid::OpticalDisc::VideoCd;
+                break;
+            } else if (!strcasecmp(dirname, "SVCD")) {
+                result = Solid::OpticalDisc::SuperVideoCd;
+                break;
+            }
+        }
+
+        if (len_di % 2 == 1) {
+            lseek(fd, 1, SEEK_CUR);
+            pos++;
+        }
+        pos += 8 + len_di;
+    }
+
+    close(fd);
+    return result;
+}
+
+void DiscProberBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QByteArrayList directories;
+    for (int i = 0; i < s_directoryCount; ++i) {
+        directories.append(QByteArray("DIR") + QByteArray::number(i).rightJustified(5, '0'));
+    }
+
+    auto write = [this](const QString &name, const QByteArray &content) {
+        QFile file(m_dir.filePath(name));
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+            return QByteArray();
+        }
+        return QFile::encodeName(file.fileName());
+    };
+
+    m_isoImage = write(QStringLiteral("dvd.iso"), iso9660Image(directories + QByteArrayList{"VIDEO_TS"}));
+    m_udfImage = write(QStringLiteral("bluray.udf"), udfImage(directories + QByteArrayList{"BDMV"}));
+    m_dataImage = write(QStringLiteral("data.iso"), iso9660Image(directories));
+    QVERIFY(!m_isoImage.isEmpty() && !m_udfImage.isEmpty() && !m_dataImage.isEmpty());
+}
+
+void DiscProberBenchmark::testProbe_data()
+{
+    QTest::addColumn<QByteArray>("image");
+    QTest::addColumn<Solid::OpticalDisc::ContentType>("content");
+
+    QTest::newRow("iso9660") << m_isoImage << Solid::OpticalDisc::VideoDvd;
+    QTest::newRow("udf") << m_udfImage << Solid::OpticalDisc::VideoBluRay;
+    QTest::newRow("data") << m_dataImage << Solid::OpticalDisc::NoContent;
+    QTest::newRow("missing") << QFile::encodeName(m_dir.filePath(QStringLiteral("missing.iso"))) << Solid::OpticalDisc::NoContent;
+}
+
+void DiscProberBenchmark::testProbe()
+{
+    QFETCH(QByteArray, image);
+    QFETCH(Solid::OpticalDisc::ContentType, content);
+
+    QCOMPARE(Solid::Backends::Shared::probeDiscContent(image), content);
+}
+
+void DiscProberBenchmark::benchmarkProbe_data()
+{
+    QTest::addColumn<QByteArray>("image");
+
+    QTest::newRow("iso9660") << m_isoImage;
+    QTest::newRow("udf") << m_udfImage;
+}
+
+void DiscProberBenchmark::benchmarkProbe()
+{
+    QFETCH(QByteArray, image);
+
+    QBENCHMARK {
+        Solid::Backends::Shared::probeDiscContent(image);
+    }
+}
+
+void DiscProberBenchmark::benchmarkLegacyProbe()
+{
+    QCOMPARE(legacyDiscDetect(m_isoImage), Solid::OpticalDisc::VideoDvd);
+
+    QBENCHMARK {
+        legacyDiscDetect(m_isoImage);
+    }
+}
+
+#include "discproberbenchmark.moc"
@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include "solid/devices/frontend/exclusionpolicy_p.h"
+
+class ExclusionPolicyTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void testDefaults();
+    void testExcludedDevices_data();
+    void testExcludedDevices();
+    void testLoopBackingFiles_data();
+    void testLoopBackingFiles();
+    void testEnvironment();
+    void testChanged();
+};
+
+QTEST_GUILESS_MAIN(ExclusionPolicyTest)
+
+void ExclusionPolicyTest::init()
+{
+    qunsetenv("SOLID_EXCLUDED_DEVICES");
+}
+
+void ExclusionPolicyTest::testDefaults()
+{
+    Solid::ExclusionPolicyPrivate policy;
+
+    QVERIFY(!policy.isActive());
+    QVERIFY(policy.excludedDevices().isEmpty());
+    QVERIFY(policy.loopBackingFiles().isEmpty());
+    QVERIFY(!policy.isExcluded(QStringLiteral("sda1"), false, QString()));
+    QVERIFY(!policy.isExcluded(QStringLiteral("loop0"), true, QStringLiteral("/tmp/disk.img")));
+}
+
+void ExclusionPolicyTest::testExcludedDevices_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("deviceName");
+    QTest::addColumn<bool>("excluded");
+
+    QTest::newRow("exact") << QStringList{QStringLiteral("sr0")} << QStringLiteral("sr0") << true;
+    QTest::newRow("exact, other device") << QStringList{QStringLiteral("sr0")} << QStringLiteral("sr1") << false;
+    QTest::newRow("whole name only") << QStringList{QStringLiteral("sda")} << QStringLiteral("sda1") << false;
+    QTest::newRow("star") << QStringList{QStringLiteral("loop*")} << QStringLiteral("loop12") << true;
+    QTest::newRow("star, other device") << QStringList{QStringLiteral("loop*")} << QStringLiteral("sda") << false;
+    QTest::newRow("question mark") << QStringList{QStringLiteral("sd?1")} << QStringLiteral("sdb1") << true;
+    QTest::newRow("question mark, one character") << QStringList{QStringLiteral("sd?1")} << QStringLiteral("sdaa1") << false;
+    QTest::newRow("bracket") << QStringList{QStringLiteral("nvme[01]n1")} << QStringLiteral("nvme1n1") << true;
+    QTest::newRow("bracket, other device") << QStringList{QStringLiteral("nvme[01]n1")} << QStringLiteral("nvme2n1") << false;
+    QTest::newRow("any of several") << QStringList{QStringLiteral("sr0"), QStringLiteral("dm-*")} << QStringLiteral("dm-3") << true;
+}
+
+void ExclusionPolicyTest::testExcludedDevices()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, deviceName);
+    QFETCH(bool, excluded);
+
+    Solid::ExclusionPolicyPrivate policy;
+    policy.setExcludedDevices(patterns);
+
+    QVERIFY(policy.isActive());
+    QCOMPARE(policy.excludedDevices(), patterns);
+    QCOMPARE(policy.isExcluded(deviceName, false, QString()), excluded);
+    // device names are excluded whatever the kind of device
+    QCOMPARE(policy.isExcluded(deviceName, true, QString()), excluded);
+}
+
+void ExclusionPolicyTest::testLoopBackingFiles_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("backingFile");
+    QTest::addColumn<bool>("excluded");
+
+    QTest::newRow("exact") << QStringList{QStringLiteral("/srv/disk.img")} << QStringLiteral("/srv/disk.img") << false;
+    QTest::newRow("exact, other file") << QStringList{QStringLiteral("/srv/disk.img")} << QStringLiteral("/srv/other.img") << true;
+    QTest::newRow("star") << QStringList{QStringLiteral("/home/*")} << QStringLiteral("/home/disk.img") << false;
+    // "/home/*" is meant to cover the subdirectories as well
+    QTest::newRow("star, subdirectory") << QStringList{QStringLiteral("/home/*")} << QStringLiteral("/home/user/images/disk.img") << false;
+    QTest::newRow("star, other directory") << QStringList{QStringLiteral("/home/*")} << QStringLiteral("/var/lib/snapd/snaps/core.snap") << true;
+    QTest::newRow("suffix") << QStringList{QStringLiteral("*.iso")} << QStringLiteral("/home/user/Downloads/distro.iso") << false;
+    QTest::newRow("suffix, other file") << QStringList{QStringLiteral("*.iso")} << QStringLiteral("/var/lib/snapd/snaps/core.snap") << true;
+    QTest::newRow("no backing file") << QStringList{QStringLiteral("/home/*")} << QString() << true;
+}
+
+void ExclusionPolicyTest::testLoopBackingFiles()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, backingFile);
+    QFETCH(bool, excluded);
+
+    Solid::ExclusionPolicyPrivate policy;
+    policy.setLoopBackingFiles(patterns);
+
+    QVERIFY(policy.isActive());
+    QCOMPARE(policy.loopBackingFiles(), patterns);
+    QCOMPARE(policy.isExcluded(QStringLiteral("loop0"), true, backingFile), excluded);
+    // only loop devices are filtered on their backing file
+    QVERIFY(!policy.isExcluded(QStringLiteral("sda1"), false, backingFile));
+}
+
+void ExclusionPolicyTest::testEnvironment()
+{
+    qputenv("SOLID_EXCLUDED_DEVICES", "sr0,,loop*,");
+
+    Solid::ExclusionPolicyPrivate policy;
+
+    QVERIFY(policy.isActive());
+    QCOMPARE(policy.excludedDevices(), (QStringList{QStringLiteral("sr0"), QStringLiteral("loop*")}));
+    QVERIFY(policy.isExcluded(QStringLiteral("sr0"), false, QString()));
+    QVERIFY(policy.isExcluded(QStringLiteral("loop7"), true, QStringLiteral("/home/disk.img")));
+    QVERIFY(!policy.isExcluded(QStringLiteral("sr1"), false, QString()));
+}
+
+void ExclusionPolicyTest::testChanged()
+{
+    Solid::ExclusionPolicyPrivate policy;
+    QSignalSpy spy(&policy, &Solid::ExclusionPolicyPrivate::changed);
+
+    policy.setExcludedDevices({QStringLiteral("sr0")});
+    QCOMPARE(spy.count(), 1);
+
+    // nothing to reevaluate when the patterns are the same
+    policy.setExcludedDevices({QStringLiteral("sr0")});
+    QCOMPARE(spy.count(), 1);
+
+    policy.setLoopBackingFiles({QStringLiteral("/home/*")});
+    QCOMPARE(spy.count(), 2);
+
+    policy.setExcludedDevices({});
+    policy.setLoopBackingFiles({});
+    QCOMPARE(spy.count(), 4);
+    QVERIFY(!policy.isActive());
+}
+
+#include "exclusionpolicytest.moc"
@@ -4,22 +4,30 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 
+#include <QFile>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
 
+#include "solid/devices/frontend/devicemanager_p.h"
 #include "solid/devices/managerbase_p.h"
 #include <solid/device.h>
 #include <solid/devicenotifier.h>
 #include <solid/genericinterface.h>
+#include <solid/livequery.h>
 #include <solid/predicate.h>
 #include <solid/processor.h>
 #include <solid/storageaccess.h>
+#include <solid/storageaccessbatch.h>
 #include <solid/storagevolume.h>
 
 #include <fakedevice.h>
 #include <fakemanager.h>
 
 #include <stdlib.h>
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
 
 #ifndef FAKE_COMPUTER_XML
 #error "FAKE_COMPUTER_XML not set. An XML file describing a computer is required for this test"
@@ -33,6 +41,8 @@ private Q_SLOTS:
     void testAllDevices();
     void testDeviceBasicFeatures();
     void testManagerSignals();
+    void testBatchedManagerSignals();
+    void testLiveQuery();
     void testDeviceSignals();
     void testDeviceExistence();
     void testDeviceInterfaceIntrospection_data();
@@ -45,10 +55,17 @@ private Q_SLOTS:
     void testQueryStorageVolumeOrStorageAccess();
     void testQueryWithParentUdi();
     void testListFromTypeProcessor();
+    void testListFromTypeHotplug();
     void testListFromTypeInvalid();
+    void testAsyncQueries();
+    void testBackendStartupTimes();
     void testSetupTeardown();
+    void testStorageAccessBatch();
+    void testStorageAccessUsage();
     void testStorageAccessFromPath();
     void testStorageAccessFromPath_data();
+    void testStorageAccessFromPathAfterMount();
+    void testStorageAccessFromPathDeviceNumber();
 
 private:
     Solid::Backends::Fake::FakeManager *fakeManager;
@@ -167,6 +184,72 @@ void SolidHwTest::testManagerSignals()
     fakeManager->plug(QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0"));
 }
 
+void SolidHwTest::testBatchedManagerSignals()
+{
+    const QString cpu0 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0");
+    const QString cpu1 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU1");
+
+    Solid::DeviceNotifier::instance()->setCoalescingInterval(50);
+    QCOMPARE(Solid::DeviceNotifier::instance()->coalescingInterval(), 50);
+
+    QSignalSpy changed(Solid::DeviceNotifier::instance(), &Solid::DeviceNotifier::devicesChanged);
+    QSignalSpy added(Solid::DeviceNotifier::instance(), &Solid::DeviceNotifier::deviceAdded);
+
+    // A remove/add pair is reported as a modification, per-UDI signals are untouched
+    fakeManager->unplug(cpu0);
+    fakeManager->plug(cpu0);
+    fakeManager->unplug(cpu1);
+    QCOMPARE(added.count(), 1);
+    QVERIFY(changed.wait());
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toStringList(), QStringList());
+    QCOMPARE(changed.at(0).at(1).toStringList(), QStringList{cpu1});
+    QCOMPARE(changed.at(0).at(2).toStringList(), QStringList{cpu0});
+
+    // An add/remove pair cancels out
+    fakeManager->plug(cpu1);
+    fakeManager->unplug(cpu1);
+    QVERIFY(!changed.wait(200));
+    QCOMPARE(changed.count(), 1);
+
+    fakeManager->plug(cpu1);
+    QVERIFY(changed.wait());
+    QCOMPARE(changed.at(1).at(0).toStringList(), QStringList{cpu1});
+}
+
+void SolidHwTest::testLiveQuery()
+{
+    const QString cpu0 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0");
+    const QString cpu1 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU1");
+
+    Solid::LiveQuery query(Solid::Predicate::fromString(QStringLiteral("Processor.maxSpeed == 3200")));
+    QCOMPARE(query.matchingUdis(), QStringList({cpu0, cpu1}));
+
+    QSignalSpy entered(&query, &Solid::LiveQuery::entered);
+    QSignalSpy left(&query, &Solid::LiveQuery::left);
+
+    // Property changes only re-evaluate the changed device
+    Solid::Backends::Fake::FakeDevice *fake = fakeManager->findDevice(cpu0);
+    fake->setProperty(QStringLiteral("maxSpeed"), 1600);
+    QCOMPARE(left.count(), 1);
+    QCOMPARE(left.at(0).at(0).toString(), cpu0);
+    QCOMPARE(query.matchingUdis(), QStringList{cpu1});
+
+    fake->setProperty(QStringLiteral("maxSpeed"), 3200);
+    QCOMPARE(entered.count(), 1);
+    QCOMPARE(entered.at(0).at(0).toString(), cpu0);
+
+    // Hotplug
+    fakeManager->unplug(cpu1);
+    QCOMPARE(left.count(), 2);
+    QCOMPARE(left.at(1).at(0).toString(), cpu1);
+
+    fakeManager->plug(cpu1);
+    QCOMPARE(entered.count(), 2);
+    QCOMPARE(entered.at(1).at(0).toString(), cpu1);
+    QCOMPARE(query.matchingUdis(), QStringList({cpu0, cpu1}));
+}
+
 void SolidHwTest::testDeviceSignals()
 {
     // A button is a nice device for testing state changes, isn't it?
@@ -462,12 +545,68 @@ void SolidHwTest::testListFromTypeProcessor()
     QCOMPARE(list.at(1).udi(), QStringLiteral("/org/kde/solid/fakehw/acpi_CPU1"));
 }
 
+void SolidHwTest::testListFromTypeHotplug()
+{
+    const auto ifaceType = Solid::DeviceInterface::Processor;
+    const auto cpu0 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0");
+    const auto cpu1 = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU1");
+    auto manager = static_cast<Solid::DeviceManagerPrivate *>(Solid::DeviceNotifier::instance());
+
+    // The listings are served from the type index, no event loop needed
+    QVERIFY(manager->isTypeIndexUsable());
+    QCOMPARE(manager->devicesOfType(ifaceType), QStringList({cpu0, cpu1}));
+    QCOMPARE(Solid::Device::listFromType(ifaceType).size(), 2);
+
+    // The type index must follow the backend notifications
+    fakeManager->unplug(cpu0);
+    QCOMPARE(manager->devicesOfType(ifaceType), QStringList({cpu1}));
+    auto list = Solid::Device::listFromType(ifaceType);
+    QCOMPARE(list.size(), 1);
+    QCOMPARE(list.at(0).udi(), cpu1);
+    QCOMPARE(Solid::Device::listFromQuery(QStringLiteral("IS Processor")).size(), 1);
+
+    // A device coming back keeps its place in the order of the backend
+    fakeManager->plug(cpu0);
+    QCOMPARE(manager->devicesOfType(ifaceType), QStringList({cpu0, cpu1}));
+    list = Solid::Device::listFromType(ifaceType);
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list.at(0).udi(), cpu0);
+    QCOMPARE(Solid::Device::listFromQuery(QStringLiteral("IS Processor")).size(), 2);
+}
+
 void SolidHwTest::testListFromTypeInvalid()
 {
     const auto list = Solid::Device::listFromQuery(QStringLiteral("blup"), QString());
     QCOMPARE(list.size(), 0);
 }
 
+void SolidHwTest::testAsyncQueries()
+{
+    auto all = Solid::Device::allDevicesAsync();
+    QTRY_VERIFY(all.isFinished());
+    QCOMPARE(all.result().size(), Solid::Device::allDevices().size());
+
+    auto processors = Solid::Device::listFromTypeAsync(Solid::DeviceInterface::Processor);
+    QTRY_VERIFY(processors.isFinished());
+    QCOMPARE(processors.result().size(), 2);
+
+    auto volumes = Solid::Device::listFromQueryAsync(QStringLiteral("StorageVolume.usage == 'FileSystem'"));
+    QTRY_VERIFY(volumes.isFinished());
+    QCOMPARE(volumes.result().size(), Solid::Device::listFromQuery(QStringLiteral("StorageVolume.usage == 'FileSystem'")).size());
+
+    auto invalid = Solid::Device::listFromQueryAsync(QStringLiteral("blup"));
+    QVERIFY(invalid.isFinished());
+    QCOMPARE(invalid.result().size(), 0);
+}
+
+void SolidHwTest::testBackendStartupTimes()
+{
+    const auto times = Solid::DeviceNotifier::instance()->backendStartupTimes();
+    QCOMPARE(times.size(), 1);
+    QVERIFY(times.contains(QStringLiteral("fakehw")));
+    QVERIFY(times.value(QStringLiteral("fakehw")) >= 0);
+}
+
 void SolidHwTest::testSetupTeardown()
 {
     Solid::StorageAccess *access;
@@ -492,6 +631,77 @@ void SolidHwTest::testSetupTeardown()
     QCOMPARE(args.at(0).toBool(), true);
 }
 
+void SolidHwTest::testStorageAccessBatch()
+{
+    const QStringList volumes = {
+        QStringLiteral("/org/kde/solid/fakehw/volume_part2_size_1024"),
+        QStringLiteral("/org/kde/solid/fakehw/volume_part5_size_1048576"),
+        QStringLiteral("/org/kde/solid/fakehw/volume_0000_unmounted_storage"),
+    };
+    const QString processor = QStringLiteral("/org/kde/solid/fakehw/acpi_CPU0");
+
+    Solid::StorageAccessBatch setup(Solid::StorageAccessBatch::Operation::Setup, volumes + QStringList{processor});
+    setup.setMaximumConcurrency(2);
+    QSignalSpy deviceDoneSpy(&setup, &Solid::StorageAccessBatch::deviceDone);
+    QSignalSpy setupSpy(&setup, &Solid::StorageAccessBatch::finished);
+
+    QVERIFY(setup.start());
+    QVERIFY(!setup.start());
+    QVERIFY(setupSpy.wait());
+    QCOMPARE(setupSpy.count(), 1);
+    QCOMPARE(setupSpy.at(0).at(0).value<Solid::ErrorType>(), Solid::OperationFailed);
+    QCOMPARE(deviceDoneSpy.count(), volumes.size() + 1);
+    QVERIFY(!setup.isRunning());
+    QCOMPARE(setup.failedDevices(), QStringList{processor});
+    QCOMPARE(setup.error(processor), Solid::InvalidOption);
+
+    for (const QString &udi : volumes) {
+        QCOMPARE(setup.error(udi), Solid::NoError);
+        QVERIFY(Solid::Device(udi).as<Solid::StorageAccess>()->isAccessible());
+    }
+
+    Solid::StorageAccessBatch teardown(Solid::StorageAccessBatch::Operation::Teardown, volumes);
+    QSignalSpy teardownSpy(&teardown, &Solid::StorageAccessBatch::finished);
+
+    QVERIFY(teardown.start());
+    QVERIFY(teardownSpy.wait());
+    QCOMPARE(teardownSpy.at(0).at(0).value<Solid::ErrorType>(), Solid::NoError);
+    QVERIFY(teardown.failedDevices().isEmpty());
+
+    for (const QString &udi : volumes) {
+        QVERIFY(!Solid::Device(udi).as<Solid::StorageAccess>()->isAccessible());
+    }
+}
+
+void SolidHwTest::testStorageAccessUsage()
+{
+#if defined(Q_OS_WIN)
+    return;
+#endif
+    // Mounted on /, which can be measured for real
+    const QString udi = QStringLiteral("/org/kde/solid/fakehw/volume_uuid_feedface");
+    Solid::Device device(udi);
+    auto access = device.as<Solid::StorageAccess>();
+    QSignalSpy spy(access, &Solid::StorageAccess::usageChanged);
+
+    access->bytesTotal();
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.at(0).at(0).toString(), udi);
+    QVERIFY(access->bytesTotal() > 0);
+    QVERIFY(access->bytesUsed() >= 0 && access->bytesUsed() <= access->bytesTotal());
+    QVERIFY(access->bytesFree() >= 0 && access->bytesFree() <= access->bytesTotal());
+
+    // An unmounted volume has no usage
+    spy.clear();
+    access->teardown();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(access->bytesTotal(), -1);
+
+    access->setup();
+    QVERIFY(spy.wait());
+    QVERIFY(access->bytesTotal() > 0);
+}
+
 void SolidHwTest::testStorageAccessFromPath()
 {
     QFETCH(QString, path);
@@ -529,4 +739,58 @@ void SolidHwTest::testStorageAccessFromPath_data()
     QTest::addRow("LUKS")            << QStringLiteral("/data")       << QStringLiteral("volume_uuid_cleartext_data_0123");
 }
 
+void SolidHwTest::testStorageAccessFromPathAfterMount()
+{
+#if defined(Q_OS_WIN)
+    return;
+#endif
+    const auto home = QStringLiteral("/org/kde/solid/fakehw/volume_uuid_c0ffee");
+    const auto root = QStringLiteral("/org/kde/solid/fakehw/volume_uuid_feedface");
+    Solid::Backends::Fake::FakeDevice *fake = fakeManager->findDevice(home);
+
+    QCOMPARE(Solid::Device::storageAccessFromPath(QStringLiteral("/home/user")).udi(), home);
+
+    // Lookups must not be served from an outdated mount table
+    fake->setProperty(QStringLiteral("mountPoint"), QStringLiteral("/srv"));
+    QCOMPARE(Solid::Device::storageAccessFromPath(QStringLiteral("/home/user")).udi(), root);
+    QCOMPARE(Solid::Device::storageAccessFromPath(QStringLiteral("/srv/www")).udi(), home);
+
+    fake->setProperty(QStringLiteral("mountPoint"), QStringLiteral("/home"));
+    QCOMPARE(Solid::Device::storageAccessFromPath(QStringLiteral("/home/user")).udi(), home);
+    QCOMPARE(Solid::Device::storageAccessFromPath(QStringLiteral("/srv/www")).udi(), root);
+}
+
+void SolidHwTest::testStorageAccessFromPathDeviceNumber()
+{
+#if !defined(Q_OS_UNIX)
+    QSKIP("Device numbers are only looked up on Unix");
+#else
+    const auto data = QStringLiteral("/org/kde/solid/fakehw/volume_uuid_cleartext_data_0123");
+    const auto nfs = QStringLiteral("/org/kde/solid/fakehw/fstab/thehost/solidpath");
+    Solid::Backends::Fake::FakeDevice *fake = fakeManager->findDevice(data);
+    Solid::Backends::Fake::FakeDevice *share = fakeManager->findDevice(nfs);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    struct stat sb;
+    QCOMPARE(::stat(QFile::encodeName(dir.path()).constData(), &sb), 0);
+
+    // The mount point prefix of the directory isn't the volume holding it
+    const QString prefixUdi = Solid::Device::storageAccessFromPath(dir.path()).udi();
+    QVERIFY(prefixUdi != data);
+
+    // The filesystem holding the path wins over the mount point prefix
+    fake->setProperty(QStringLiteral("deviceNumber"), quint64(sb.st_dev));
+    QCOMPARE(Solid::Device::storageAccessFromPath(dir.path()).udi(), data);
+
+    // Network shares are resolved through the prefix only
+    share->setProperty(QStringLiteral("mountPoint"), dir.path());
+    QCOMPARE(Solid::Device::storageAccessFromPath(dir.path()).udi(), nfs);
+    share->setProperty(QStringLiteral("mountPoint"), QStringLiteral("/media/nfs"));
+
+    fake->removeProperty(QStringLiteral("deviceNumber"));
+    QCOMPARE(Solid::Device::storageAccessFromPath(dir.path()).udi(), prefixUdi);
+#endif
+}
+
 #include "solidhwtest.moc"
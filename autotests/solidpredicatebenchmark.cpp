@@ -0,0 +1,238 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QMetaEnum>
+#include <QMetaProperty>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <solid/device.h>
+#include <solid/deviceinterface.h>
+#include <solid/predicate.h>
+#include <solid/storagevolume.h>
+
+class SolidPredicateBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkMatches_data();
+    void benchmarkMatches();
+    void benchmarkMatchesUncompiled_data();
+    void benchmarkMatchesUncompiled();
+    void benchmarkListFromQuery();
+
+private:
+    QTemporaryDir m_dir;
+    QList<Solid::Device> m_devices;
+};
+
+QTEST_MAIN(SolidPredicateBenchmark)
+
+static const int s_deviceCount = 2000;
+
+// Number of indices in [0, s_deviceCount) verifying @p condition
+template<typename Condition>
+static int countIndices(Condition condition)
+{
+    int count = 0;
+    for (int i = 0; i < s_deviceCount; ++i) {
+        if (condition(i)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Predicate::matches() as it was before checks got compiled, resolving the
+// meta-property and the expected value again for every device
+static bool matchesUncompiled(const Solid::Predicate &predicate, const Solid::Device &device)
+{
+    if (!predicate.isValid()) {
+        return false;
+    }
+
+    switch (predicate.type()) {
+    case Solid::Predicate::Disjunction:
+        return matchesUncompiled(predicate.firstOperand(), device) || matchesUncompiled(predicate.secondOperand(), device);
+    case Solid::Predicate::Conjunction:
+        return matchesUncompiled(predicate.firstOperand(), device) && matchesUncompiled(predicate.secondOperand(), device);
+    case Solid::Predicate::PropertyCheck: {
+        const Solid::DeviceInterface *iface = device.asDeviceInterface(predicate.interfaceType());
+        if (iface == nullptr) {
+            return false;
+        }
+
+        const int index = iface->metaObject()->indexOfProperty(predicate.propertyName().toLatin1().constData());
+        const QMetaProperty metaProp = iface->metaObject()->property(index);
+        const QVariant value = metaProp.isReadable() ? metaProp.read(iface) : QVariant();
+        QVariant expected = predicate.matchingValue();
+
+        if (metaProp.isEnumType() && expected.userType() == QMetaType::QString) {
+            int enumValue = metaProp.enumerator().keysToValue(expected.toString().toLatin1().constData());
+            expected = enumValue >= 0 ? QVariant(metaProp.metaType(), &enumValue) : QVariant();
+        } else if (metaProp.isEnumType() && expected.userType() == QMetaType::Int) {
+            int expectedValue = expected.toInt();
+            expected = QVariant(metaProp.metaType(), &expectedValue);
+        }
+
+        if (predicate.comparisonOperator() == Solid::Predicate::Mask) {
+            bool v_ok;
+            const int v = value.toInt(&v_ok);
+            bool e_ok;
+            const int e = expected.toInt(&e_ok);
+            return e_ok && v_ok && (v & e);
+        }
+
+        if (value == expected) {
+            return true;
+        }
+
+        if (value.canConvert<QSequentialIterable>()) {
+            const auto iterable = value.value<QSequentialIterable>();
+            for (const auto &element : iterable) {
+                if (element == expected) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    case Solid::Predicate::InterfaceCheck:
+        return device.isDeviceInterface(predicate.interfaceType());
+    }
+
+    return false;
+}
+
+void SolidPredicateBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // A machine with a few thousand processors and volumes
+    QString xml = QStringLiteral("<machine>\n");
+    for (int i = 0; i < s_deviceCount; ++i) {
+        xml += QStringLiteral(
+                   "<device udi=\"/org/kde/solid/fakehw/cpu_%1\">"
+                   "<property key=\"interfaces\">Processor</property>"
+                   "<property key=\"number\">%1</property>"
+                   "<property key=\"maxSpeed\">%2</property>"
+                   "<property key=\"canChangeFrequency\">%3</property>"
+                   "</device>\n")
+                   .arg(i)
+                   .arg(i % 2 ? 3200 : 2400)
+                   .arg(i % 3 ? QStringLiteral("true") : QStringLiteral("false"));
+        xml += QStringLiteral(
+                   "<device udi=\"/org/kde/solid/fakehw/volume_%1\">"
+                   "<property key=\"interfaces\">StorageVolume</property>"
+                   "<property key=\"usage\">%2</property>"
+                   "<property key=\"isIgnored\">false</property>"
+                   "<property key=\"size\">%3</property>"
+                   "</device>\n")
+                   .arg(i)
+                   .arg(i % 4 ? QStringLiteral("filesystem") : QStringLiteral("other"))
+                   .arg(qulonglong(i) * 1048576);
+    }
+    xml += QStringLiteral("</machine>\n");
+
+    QFile machine(m_dir.filePath(QStringLiteral("machine.xml")));
+    QVERIFY(machine.open(QIODevice::WriteOnly));
+    machine.write(xml.toUtf8());
+    machine.close();
+
+    qputenv("SOLID_FAKEHW", QFile::encodeName(machine.fileName()));
+
+    m_devices = Solid::Device::allDevices();
+    QCOMPARE(m_devices.size(), 2 * s_deviceCount);
+}
+
+void SolidPredicateBenchmark::benchmarkMatches_data()
+{
+    QTest::addColumn<QString>("predicate");
+    QTest::addColumn<int>("expected");
+
+    const auto isFast = [](int i) {
+        return i % 2 != 0;
+    };
+    const auto isFileSystem = [](int i) {
+        return i % 4 != 0;
+    };
+    const auto canChangeFrequency = [](int i) {
+        return i % 3 != 0;
+    };
+
+    QTest::newRow("int") << QStringLiteral("Processor.maxSpeed == 3200") << countIndices(isFast);
+    QTest::newRow("enum by name") << QStringLiteral("StorageVolume.usage == 'FileSystem'") << countIndices(isFileSystem);
+    QTest::newRow("enum by value") << QStringLiteral("StorageVolume.usage == %1").arg(int(Solid::StorageVolume::Other)) << countIndices([&](int i) {
+        return !isFileSystem(i);
+    });
+    QTest::newRow("conjunction") << QStringLiteral("[Processor.maxSpeed == 3200 AND Processor.canChangeFrequency == true]") << countIndices([&](int i) {
+        return isFast(i) && canChangeFrequency(i);
+    });
+}
+
+void SolidPredicateBenchmark::benchmarkMatches()
+{
+    QFETCH(QString, predicate);
+    QFETCH(int, expected);
+
+    const Solid::Predicate p = Solid::Predicate::fromString(predicate);
+    QVERIFY(p.isValid());
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const Solid::Device &device : std::as_const(m_devices)) {
+            if (p.matches(device)) {
+                ++matched;
+            }
+        }
+    }
+
+    QCOMPARE(matched, expected);
+}
+
+void SolidPredicateBenchmark::benchmarkMatchesUncompiled_data()
+{
+    benchmarkMatches_data();
+}
+
+void SolidPredicateBenchmark::benchmarkMatchesUncompiled()
+{
+    QFETCH(QString, predicate);
+    QFETCH(int, expected);
+
+    const Solid::Predicate p = Solid::Predicate::fromString(predicate);
+    QVERIFY(p.isValid());
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const Solid::Device &device : std::as_const(m_devices)) {
+            if (matchesUncompiled(p, device)) {
+                ++matched;
+            }
+        }
+    }
+
+    QCOMPARE(matched, expected);
+}
+
+void SolidPredicateBenchmark::benchmarkListFromQuery()
+{
+    const Solid::Predicate p = Solid::Predicate::fromString(QStringLiteral("[StorageVolume.usage == 'FileSystem' OR Processor.maxSpeed == 3200]"));
+    QVERIFY(p.isValid());
+
+    QList<Solid::Device> list;
+    QBENCHMARK {
+        list = Solid::Device::listFromQuery(p);
+    }
+
+    QVERIFY(!list.isEmpty());
+}
+
+#include "solidpredicatebenchmark.moc"
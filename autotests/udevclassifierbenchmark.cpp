@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QTest>
+
+#include "udevdeviceclassifier.h"
+
+using Solid::Backends::UDev::DeviceClassifier;
+
+class UdevClassifierBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testMatchesLegacy();
+    void benchmarkClassify();
+    void benchmarkLegacyClassify();
+
+private:
+    UdevQt::DeviceList m_devices;
+};
+
+QTEST_GUILESS_MAIN(UdevClassifierBenchmark)
+
+// The classifier this one replaces, going through QString and QVariant for each lookup
+static bool legacyCheckOfInterest(const UdevQt::Device &device)
+{
+    const QString subsystem = device.subsystem();
+
+    if (subsystem == QLatin1String("cpu")) {
+        return QFile::exists(device.sysfsPath() + QStringLiteral("/sysdev")) //
+            || QFile::exists(device.sysfsPath() + QStringLiteral("/cpufreq")) //
+            || QFile::exists(device.sysfsPath() + QStringLiteral("/topology/core_id"));
+    }
+    if (subsystem == QLatin1String("sound") && device.deviceProperty(QStringLiteral("SOUND_FORM_FACTOR")).toString() != QStringLiteral("internal")) {
+        return true;
+    }
+
+    if (subsystem == QLatin1String("tty")) {
+        QString path = device.deviceProperty(QStringLiteral("DEVPATH")).toString();
+
+        int lastSlash = path.length() - path.lastIndexOf(QLatin1String("/")) - 1;
+        QByteArray lastElement = path.right(lastSlash).toLatin1();
+
+        if (lastElement.startsWith("tty") && !path.startsWith(QStringLiteral("/devices/virtual"))) {
+            return true;
+        }
+    }
+
+    if (subsystem == QLatin1String("input")) {
+        /* clang-format off */
+        if (device.deviceProperty(QStringLiteral("ID_INPUT_MOUSE")).toInt() == 1
+            || device.deviceProperty(QStringLiteral("ID_INPUT_TOUCHPAD")).toInt() == 1
+            || device.deviceProperty(QStringLiteral("ID_INPUT_TABLET")).toInt() == 1
+            || device.deviceProperty(QStringLiteral("ID_INPUT_JOYSTICK")).toInt() == 1
+            || device.deviceProperty(QStringLiteral("ID_INPUT_TOUCHSCREEN")).toInt() == 1) { /* clang-format on */
+            return true;
+        }
+    }
+
+    /* clang-format off */
+    return subsystem == QLatin1String("dvb")
+        || subsystem == QLatin1String("net")
+        || (!device.deviceProperty(QStringLiteral("ID_MEDIA_PLAYER")).toString().isEmpty()
+            && device.parent().deviceProperty(QStringLiteral("ID_MEDIA_PLAYER")).toString().isEmpty())
+        || (device.deviceProperty(QStringLiteral("ID_GPHOTO2")).toInt() == 1
+            && device.parent().deviceProperty(QStringLiteral("ID_GPHOTO2")).toInt() != 1);
+    /* clang-format on */
+}
+
+void UdevClassifierBenchmark::initTestCase()
+{
+    UdevQt::Client client;
+    m_devices = client.allDevices();
+    if (m_devices.isEmpty()) {
+        QSKIP("No udev devices to classify");
+    }
+}
+
+void UdevClassifierBenchmark::testMatchesLegacy()
+{
+    const DeviceClassifier &classifier = DeviceClassifier::instance();
+    for (const UdevQt::Device &device : std::as_const(m_devices)) {
+        QVERIFY2(classifier.isOfInterest(device) == legacyCheckOfInterest(device), qPrintable(device.sysfsPath()));
+    }
+}
+
+void UdevClassifierBenchmark::benchmarkClassify()
+{
+    const DeviceClassifier &classifier = DeviceClassifier::instance();
+    int ofInterest = 0;
+    QBENCHMARK {
+        ofInterest = 0;
+        for (const UdevQt::Device &device : std::as_const(m_devices)) {
+            ofInterest += classifier.isOfInterest(device);
+        }
+    }
+    QVERIFY(ofInterest <= m_devices.size());
+}
+
+void UdevClassifierBenchmark::benchmarkLegacyClassify()
+{
+    int ofInterest = 0;
+    QBENCHMARK {
+        ofInterest = 0;
+        for (const UdevQt::Device &device : std::as_const(m_devices)) {
+            ofInterest += legacyCheckOfInterest(device);
+        }
+    }
+    QVERIFY(ofInterest <= m_devices.size());
+}
+
+#include "udevclassifierbenchmark.moc"
@@ -161,6 +161,7 @@ void FakeManager::plug(const QString &udi)
     if (d->hiddenDevices.contains(udi)) {
         QMap<QString, QVariant> properties = d->hiddenDevices.take(udi);
         d->loadedDevices[udi] = new FakeDevice(udi, properties);
+        watchMountPoint(d->loadedDevices[udi]);
         Q_EMIT deviceAdded(udi);
     }
 }
@@ -175,6 +176,36 @@ void FakeManager::unplug(const QString &udi)
     }
 }
 
+bool FakeManager::notifiesMountPointChanges() const
+{
+    return true;
+}
+
+QHash<quint64, QString> FakeManager::deviceNumbers()
+{
+    QHash<quint64, QString> result;
+
+    // Only the devices given a "deviceNumber" property, the fake mount points don't exist
+    for (const FakeDevice *device : std::as_const(d->loadedDevices)) {
+        const quint64 deviceNumber = device->property(QStringLiteral("deviceNumber")).toULongLong();
+        if (deviceNumber != 0 && device->property(QStringLiteral("isMounted")).toBool() && !result.contains(deviceNumber)) {
+            result.insert(deviceNumber, device->udi());
+        }
+    }
+
+    return result;
+}
+
+void FakeManager::watchMountPoint(FakeDevice *device)
+{
+    connect(device, &FakeDevice::propertyChanged, this, [this](const QMap<QString, int> &changes) {
+        if (changes.contains(QStringLiteral("mountPoint")) || changes.contains(QStringLiteral("usage"))
+            || changes.contains(QStringLiteral("isMounted")) || changes.contains(QStringLiteral("deviceNumber"))) {
+            Q_EMIT mountPointsChanged();
+        }
+    });
+}
+
 void FakeManager::parseMachineFile()
 {
     QFile machineFile(d->xmlFile);
@@ -201,6 +232,7 @@ void FakeManager::parseMachineFile()
             if (tempDevice) {
                 Q_ASSERT(!d->loadedDevices.contains(tempDevice->udi()));
                 d->loadedDevices.insert(tempDevice->udi(), tempDevice);
+                watchMountPoint(tempDevice);
                 Q_EMIT deviceAdded(tempDevice->udi());
             }
         }
@@ -47,6 +47,9 @@ public:
     QObject *createDevice(const QString &udi) override;
     virtual FakeDevice *findDevice(const QString &udi);
 
+    bool notifiesMountPointChanges() const override;
+    QHash<quint64, QString> deviceNumbers() override;
+
 public Q_SLOTS:
     void plug(const QString &udi);
     void unplug(const QString &udi);
@@ -66,6 +69,7 @@ private Q_SLOTS:
 private:
     QStringList findDeviceStringMatch(const QString &key, const QString &value);
     QStringList findDeviceByDeviceInterface(Solid::DeviceInterface::Type type);
+    void watchMountPoint(FakeDevice *device);
 
     class Private;
     Private *d;
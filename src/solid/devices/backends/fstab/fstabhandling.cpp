@@ -9,12 +9,12 @@
 #include "fstab_debug.h"
 
 #include <QFile>
+#include <QMutexLocker>
 #include <QObject>
 #include <QProcess>
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QTextStream>
-#include <QThreadStorage>
 
 #include <solid/devices/soliddefs_p.h>
 
@@ -42,7 +42,8 @@
 // libmount for linux
 // getmntinfo + struct statfs&flags (BSD 4.4 and friends)
 
-Q_GLOBAL_STATIC(QThreadStorage<Solid::Backends::Fstab::FstabHandling>, globalFstabCache)
+// One cache for the whole process, every thread reads the same parsed tables
+Q_GLOBAL_STATIC(Solid::Backends::Fstab::FstabHandling, globalFstabCache)
 
 Solid::Backends::Fstab::FstabHandling::FstabHandling()
     : m_fstabCacheValid(false)
@@ -106,12 +107,12 @@ QString _k_deviceNameForMountpoint(const QString &source, const QString &fstype,
 
 void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
 {
-    if (globalFstabCache->localData().m_fstabCacheValid) {
+    if (globalFstabCache->m_fstabCacheValid) {
         return;
     }
 
-    globalFstabCache->localData().m_fstabCache.clear();
-    globalFstabCache->localData().m_fstabOptionsCache.clear();
+    globalFstabCache->m_fstabCache.clear();
+    globalFstabCache->m_fstabOptionsCache.clear();
 
 #if HAVE_LIBMOUNT
 
@@ -138,14 +139,14 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
             const QStringList options = QFile::decodeName(name).split(QLatin1Char(','));
             free(name);
 
-            globalFstabCache->localData().m_fstabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, fstype);
+            globalFstabCache->m_fstabCache.insert(device, mountpoint);
+            globalFstabCache->m_fstabFstypeCache.insert(device, fstype);
             for (const auto &optionLine : options) {
                 const auto split = optionLine.split(QLatin1Char('='));
                 const auto optionName = split[0];
                 const auto optionValue = split.size() > 1 ? split[1] : QString{};
 
-                globalFstabCache->localData().m_fstabOptionsCache[device].insert(optionName, optionValue);
+                globalFstabCache->m_fstabOptionsCache[device].insert(optionName, optionValue);
             }
         }
     }
@@ -190,26 +191,28 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateFstabMountPointsCache()
                 }
             }
 
-            globalFstabCache->localData().m_fstabCache.insert(device, mountpoint);
+            globalFstabCache->m_fstabCache.insert(device, mountpoint);
         }
     }
 
     fstab.close();
 #endif
-    globalFstabCache->localData().m_fstabCacheValid = true;
+    globalFstabCache->m_fstabCacheValid = true;
 }
 
 QStringList Solid::Backends::Fstab::FstabHandling::deviceList()
 {
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
     _k_updateFstabMountPointsCache();
     _k_updateMtabMountPointsCache();
 
-    QStringList devices = globalFstabCache->localData().m_mtabCache.keys();
+    QStringList devices = globalFstabCache->m_mtabCache.keys();
 
     // Ensure that regardless an fstab device ends with a slash
     // it will match its eventual mounted device regardless whether or not its path
     // ends with a slash
-    for (auto it = globalFstabCache->localData().m_fstabCache.constBegin(), end = globalFstabCache->localData().m_fstabCache.constEnd(); it != end; ++it) {
+    for (auto it = globalFstabCache->m_fstabCache.constBegin(), end = globalFstabCache->m_fstabCache.constEnd(); it != end; ++it) {
         auto device = it.key();
         // the device is already known
         if (devices.contains(device)) {
@@ -232,23 +235,27 @@ QStringList Solid::Backends::Fstab::FstabHandling::deviceList()
 
 QStringList Solid::Backends::Fstab::FstabHandling::mountPoints(const QString &device)
 {
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
     _k_updateFstabMountPointsCache();
     _k_updateMtabMountPointsCache();
 
-    QStringList mountpoints = globalFstabCache->localData().m_fstabCache.values(device);
-    mountpoints += globalFstabCache->localData().m_mtabCache.values(device);
+    QStringList mountpoints = globalFstabCache->m_fstabCache.values(device);
+    mountpoints += globalFstabCache->m_mtabCache.values(device);
     mountpoints.removeDuplicates();
     return mountpoints;
 }
 
 QHash<QString, QString> Solid::Backends::Fstab::FstabHandling::options(const QString &device)
 {
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
     _k_updateFstabMountPointsCache();
     _k_updateMtabMountPointsCache();
 
-    auto options = globalFstabCache->localData().m_mtabOptionsCache.value(device);
+    auto options = globalFstabCache->m_mtabOptionsCache.value(device);
 
-    const auto optionsFstab = globalFstabCache->localData().m_fstabOptionsCache.value(device);
+    const auto optionsFstab = globalFstabCache->m_fstabOptionsCache.value(device);
     for (const auto &it : optionsFstab.asKeyValueRange()) {
         if (!options.contains(it.first)) {
             options.insert(it.first, it.second);
@@ -260,9 +267,11 @@ QHash<QString, QString> Solid::Backends::Fstab::FstabHandling::options(const QSt
 
 QString Solid::Backends::Fstab::FstabHandling::fstype(const QString &device)
 {
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
     _k_updateFstabMountPointsCache();
 
-    return globalFstabCache->localData().m_fstabFstypeCache.value(device);
+    return globalFstabCache->m_fstabFstypeCache.value(device);
 }
 
 bool Solid::Backends::Fstab::FstabHandling::callSystemCommand(const QString &commandName,
@@ -306,12 +315,13 @@ bool Solid::Backends::Fstab::FstabHandling::callSystemCommand(const QString &com
 
 void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
 {
-    if (globalFstabCache->localData().m_mtabCacheValid) {
+    if (globalFstabCache->m_mtabCacheValid) {
         return;
     }
 
-    globalFstabCache->localData().m_mtabCache.clear();
-    globalFstabCache->localData().m_mtabOptionsCache.clear();
+    globalFstabCache->m_mtabCache.clear();
+    globalFstabCache->m_mtabOptionsCache.clear();
+    globalFstabCache->m_mtabDeviceNumberCache.clear();
 
 #if HAVE_GETMNTINFO
 
@@ -329,8 +339,8 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
             const QString fsname = QFile::decodeName(mounted[i].f_mntfromname);
             const QString mountpoint = QFile::decodeName(mounted[i].f_mntonname);
             const QString device = _k_deviceNameForMountpoint(fsname, type, mountpoint);
-            globalFstabCache->localData().m_mtabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, type);
+            globalFstabCache->m_mtabCache.insert(device, mountpoint);
+            globalFstabCache->m_fstabFstypeCache.insert(device, type);
         }
     }
 
@@ -359,14 +369,21 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
             const QStringList options = QFile::decodeName(name).split(QLatin1Char(','));
             free(name);
 
-            globalFstabCache->localData().m_mtabCache.insert(device, mountpoint);
-            globalFstabCache->localData().m_fstabFstypeCache.insert(device, fstype);
+            globalFstabCache->m_mtabCache.insert(device, mountpoint);
+            globalFstabCache->m_fstabFstypeCache.insert(device, fstype);
+
+            // Bind mounts share the number of their source, the first mount wins
+            const quint64 devno = mnt_fs_get_devno(fs);
+            if (devno != 0 && !globalFstabCache->m_mtabDeviceNumberCache.contains(devno)) {
+                globalFstabCache->m_mtabDeviceNumberCache.insert(devno, device);
+            }
+
             for (const auto &optionLine : options) {
                 const auto split = optionLine.split(QLatin1Char('='));
                 const auto optionName = split[0];
                 const auto optionValue = split.size() > 1 ? split[1] : QString{};
 
-                globalFstabCache->localData().m_mtabOptionsCache[device].insert(optionName, optionValue);
+                globalFstabCache->m_mtabOptionsCache[device].insert(optionName, optionValue);
             }
         }
     }
@@ -377,21 +394,33 @@ void Solid::Backends::Fstab::FstabHandling::_k_updateMtabMountPointsCache()
 
 #endif
 
-    globalFstabCache->localData().m_mtabCacheValid = true;
+    globalFstabCache->m_mtabCacheValid = true;
 }
 
 QStringList Solid::Backends::Fstab::FstabHandling::currentMountPoints(const QString &device)
 {
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
+    _k_updateMtabMountPointsCache();
+    return globalFstabCache->m_mtabCache.values(device);
+}
+
+QHash<quint64, QString> Solid::Backends::Fstab::FstabHandling::currentDeviceNumbers()
+{
+    QMutexLocker locker(&globalFstabCache->m_lock);
+
     _k_updateMtabMountPointsCache();
-    return globalFstabCache->localData().m_mtabCache.values(device);
+    return globalFstabCache->m_mtabDeviceNumberCache;
 }
 
 void Solid::Backends::Fstab::FstabHandling::flushMtabCache()
 {
-    globalFstabCache->localData().m_mtabCacheValid = false;
+    QMutexLocker locker(&globalFstabCache->m_lock);
+    globalFstabCache->m_mtabCacheValid = false;
 }
 
 void Solid::Backends::Fstab::FstabHandling::flushFstabCache()
 {
-    globalFstabCache->localData().m_fstabCacheValid = false;
+    QMutexLocker locker(&globalFstabCache->m_lock);
+    globalFstabCache->m_fstabCacheValid = false;
 }
@@ -9,6 +9,7 @@
 #define SOLID_BACKENDS_FSTAB_FSTABHANDLING_H
 
 #include <QMultiHash>
+#include <QMutex>
 #include <QString>
 
 #include <functional>
@@ -29,6 +30,7 @@ public:
 
     static QStringList deviceList();
     static QStringList currentMountPoints(const QString &device);
+    static QHash<quint64, QString> currentDeviceNumbers();
     static QStringList mountPoints(const QString &device);
     static QHash<QString, QString> options(const QString &device);
     static QString fstype(const QString &device);
@@ -37,6 +39,7 @@ public:
     static void flushFstabCache();
 
 private:
+    // both expect m_lock to be held by the caller
     static void _k_updateMtabMountPointsCache();
     static void _k_updateFstabMountPointsCache();
 
@@ -46,9 +49,13 @@ private:
     QStringMultiHash m_fstabCache;
     QHash<QString, QHash<QString, QString>> m_fstabOptionsCache;
     QHash<QString, QHash<QString, QString>> m_mtabOptionsCache;
+    QHash<quint64, QString> m_mtabDeviceNumberCache;
     QHash<QString, QString> m_fstabFstypeCache;
     bool m_fstabCacheValid;
     bool m_mtabCacheValid;
+
+    // guards the caches, which are shared by all threads
+    QMutex m_lock;
 };
 
 }
@@ -17,20 +17,29 @@ using namespace Solid::Backends::Shared;
 
 FstabManager::FstabManager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent)
+    , m_supportedInterfaces(staticSupportedInterfaces())
     , m_deviceList(FstabHandling::deviceList())
 {
-    m_supportedInterfaces << Solid::DeviceInterface::StorageAccess;
-    m_supportedInterfaces << Solid::DeviceInterface::NetworkShare;
 
     connect(FstabWatcher::instance(), &FstabWatcher::fstabChanged, this, &FstabManager::onFstabChanged);
     connect(FstabWatcher::instance(), &FstabWatcher::mtabChanged, this, &FstabManager::onMtabChanged);
 }
 
-QString FstabManager::udiPrefix() const
+QString FstabManager::staticUdiPrefix()
 {
     return QStringLiteral(FSTAB_UDI_PREFIX);
 }
 
+QSet<Solid::DeviceInterface::Type> FstabManager::staticSupportedInterfaces()
+{
+    return {Solid::DeviceInterface::StorageAccess, Solid::DeviceInterface::NetworkShare};
+}
+
+QString FstabManager::udiPrefix() const
+{
+    return staticUdiPrefix();
+}
+
 QSet<Solid::DeviceInterface::Type> FstabManager::supportedInterfaces() const
 {
     return m_supportedInterfaces;
@@ -72,6 +81,27 @@ QStringList FstabManager::devicesFromQuery(const QString &parentUdi, Solid::Devi
     return QStringList();
 }
 
+Solid::Ifaces::DeviceManager::MatchResult FstabManager::matchNatively(const QString &udi, const Solid::Predicate &check)
+{
+    if (udi == udiPrefix() || check.interfaceType() != Solid::DeviceInterface::StorageAccess) {
+        return MatchResult::Unknown;
+    }
+
+    if (check.type() == Solid::Predicate::InterfaceCheck) {
+        return MatchResult::Match;
+    }
+
+    // Answer accessibility from the mtab cache rather than building a FstabStorageAccess
+    if (check.propertyName() == QLatin1String("accessible") && check.comparisonOperator() == Solid::Predicate::Equals
+        && check.matchingValue().typeId() == QMetaType::Bool) {
+        const QString device = udi.mid(udiPrefix().length() + 1, -1);
+        const bool accessible = !FstabHandling::currentMountPoints(device).isEmpty();
+        return accessible == check.matchingValue().toBool() ? MatchResult::Match : MatchResult::NoMatch;
+    }
+
+    return MatchResult::Unknown;
+}
+
 QObject *FstabManager::createDevice(const QString &udi)
 {
     if (udi == udiPrefix()) {
@@ -96,10 +126,31 @@ QObject *FstabManager::createDevice(const QString &udi)
     }
 }
 
+bool FstabManager::notifiesMountPointChanges() const
+{
+    return true;
+}
+
+QHash<quint64, QString> FstabManager::deviceNumbers()
+{
+    QHash<quint64, QString> result;
+
+    const QHash<quint64, QString> devices = FstabHandling::currentDeviceNumbers();
+    for (auto it = devices.cbegin(); it != devices.cend(); ++it) {
+        if (m_deviceList.contains(it.value())) {
+            result.insert(it.key(), udiPrefix() + QStringLiteral("/") + it.value());
+        }
+    }
+
+    return result;
+}
+
 void FstabManager::onFstabChanged()
 {
     FstabHandling::flushFstabCache();
     _k_updateDeviceList();
+
+    Q_EMIT mountPointsChanged();
 }
 
 void FstabManager::_k_updateDeviceList()
@@ -135,6 +186,8 @@ void FstabManager::onMtabChanged()
         // notify storageaccess objects via device ...
         Q_EMIT mtabChanged(device);
     }
+
+    Q_EMIT mountPointsChanged();
 }
 
 FstabManager::~FstabManager()
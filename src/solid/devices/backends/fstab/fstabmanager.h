@@ -28,11 +28,20 @@ public:
     explicit FstabManager(QObject *parent);
     ~FstabManager() override;
 
+    // What the backend declares before it exists, for it to be created lazily
+    static QString staticUdiPrefix();
+    static QSet<Solid::DeviceInterface::Type> staticSupportedInterfaces();
+
     QString udiPrefix() const override;
     QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
     QStringList allDevices() override;
     QStringList devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type) override;
     QObject *createDevice(const QString &udi) override;
+    bool notifiesMountPointChanges() const override;
+    QHash<quint64, QString> deviceNumbers() override;
+
+protected:
+    MatchResult matchNatively(const QString &udi, const Solid::Predicate &check) override;
 
 Q_SIGNALS:
     void mtabChanged(const QString &device);
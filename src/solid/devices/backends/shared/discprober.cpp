@@ -0,0 +1,446 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "discprober.h"
+
+#include <QList>
+#include <QString>
+#include <QtEndian>
+
+#include <utility>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <QFile>
+#endif
+
+namespace
+{
+constexpr qint64 s_sectorSize = 2048;
+// Volume descriptors start at sector 16, the UDF recognition sequence follows the ISO 9660 ones
+constexpr qint64 s_descriptorsSector = 16;
+constexpr int s_descriptorsCount = 16;
+// Anchor volume descriptor pointer of UDF
+constexpr qint64 s_anchorSector = 256;
+// Upper bound of the structures read at once, path tables are a few KiB for thousands of directories
+constexpr qint64 s_maximumReadSize = 1024 * 1024;
+
+// UDF descriptor tags
+constexpr quint16 s_tagAnchor = 2;
+constexpr quint16 s_tagPartition = 5;
+constexpr quint16 s_tagLogicalVolume = 6;
+constexpr quint16 s_tagTerminating = 8;
+constexpr quint16 s_tagFileSet = 256;
+constexpr quint16 s_tagFileIdentifier = 257;
+constexpr quint16 s_tagFileEntry = 261;
+constexpr quint16 s_tagExtendedFileEntry = 266;
+
+class DiscReader
+{
+public:
+    explicit DiscReader(const QByteArray &deviceFile)
+    {
+#if defined(Q_OS_UNIX)
+        m_fd = ::open(deviceFile.constData(), O_RDONLY | O_CLOEXEC);
+#else
+        m_file.setFileName(QFile::decodeName(deviceFile));
+        m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+#endif
+    }
+
+    ~DiscReader()
+    {
+#if defined(Q_OS_UNIX)
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+#endif
+    }
+
+    DiscReader(const DiscReader &) = delete;
+    DiscReader &operator=(const DiscReader &) = delete;
+
+    bool isOpen() const
+    {
+#if defined(Q_OS_UNIX)
+        return m_fd >= 0;
+#else
+        return m_file.isOpen();
+#endif
+    }
+
+    // Returns less than @p size bytes if the disc ends before
+    QByteArray read(qint64 offset, qint64 size)
+    {
+        if (offset < 0 || size <= 0) {
+            return QByteArray();
+        }
+
+        QByteArray data(qMin(size, s_maximumReadSize), Qt::Uninitialized);
+        qint64 done = 0;
+#if defined(Q_OS_UNIX)
+        while (done < data.size()) {
+            const ssize_t count = ::pread(m_fd, data.data() + done, data.size() - done, offset + done);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            done += count;
+        }
+#else
+        if (m_file.seek(offset)) {
+            done = qMax<qint64>(m_file.read(data.data(), data.size()), 0);
+        }
+#endif
+        data.truncate(done);
+        return data;
+    }
+
+private:
+#if defined(Q_OS_UNIX)
+    int m_fd = -1;
+#else
+    QFile m_file;
+#endif
+};
+
+// Little-endian fields, 0 when out of bounds
+quint8 byteAt(const QByteArray &data, qsizetype offset)
+{
+    return offset >= 0 && offset < data.size() ? quint8(data.at(offset)) : 0;
+}
+
+quint16 le16(const QByteArray &data, qsizetype offset)
+{
+    return offset >= 0 && offset + 2 <= data.size() ? qFromLittleEndian<quint16>(data.constData() + offset) : 0;
+}
+
+quint32 le32(const QByteArray &data, qsizetype offset)
+{
+    return offset >= 0 && offset + 4 <= data.size() ? qFromLittleEndian<quint32>(data.constData() + offset) : 0;
+}
+
+Solid::OpticalDisc::ContentType contentOfDirectory(const QString &name)
+{
+    if (name.compare(QLatin1String("VIDEO_TS"), Qt::CaseInsensitive) == 0) {
+        return Solid::OpticalDisc::VideoDvd;
+    } else if (name.compare(QLatin1String("BDMV"), Qt::CaseInsensitive) == 0) {
+        return Solid::OpticalDisc::VideoBluRay;
+    } else if (name.compare(QLatin1String("VCD"), Qt::CaseInsensitive) == 0) {
+        return Solid::OpticalDisc::VideoCd;
+    } else if (name.compare(QLatin1String("SVCD"), Qt::CaseInsensitive) == 0) {
+        return Solid::OpticalDisc::SuperVideoCd;
+    }
+    return Solid::OpticalDisc::NoContent;
+}
+
+Solid::OpticalDisc::ContentType probeIso9660(DiscReader &reader, const QByteArray &primaryDescriptor)
+{
+    const quint16 blockSize = le16(primaryDescriptor, 128);
+    const quint32 tableSize = le32(primaryDescriptor, 132);
+    const quint32 tableBlock = le32(primaryDescriptor, 140);
+    if (blockSize == 0 || tableSize == 0) {
+        return Solid::OpticalDisc::NoContent;
+    }
+
+    const QByteArray table = reader.read(qint64(blockSize) * tableBlock, tableSize);
+
+    // Records: name length, extended attribute length, extent location,
+    // parent directory number, name, padding to an even length
+    qsizetype pos = 0;
+    while (pos + 8 <= table.size()) {
+        const quint8 nameLength = byteAt(table, pos);
+        if (nameLength == 0 || pos + 8 + nameLength > table.size()) {
+            break;
+        }
+
+        // The first record is the root directory
+        if (le16(table, pos + 6) == 1) {
+            const auto content = contentOfDirectory(QString::fromLatin1(table.constData() + pos + 8, nameLength));
+            if (content != Solid::OpticalDisc::NoContent) {
+                return content;
+            }
+        }
+
+        pos += 8 + nameLength + (nameLength % 2);
+    }
+
+    return Solid::OpticalDisc::NoContent;
+}
+
+class UdfVolume
+{
+public:
+    explicit UdfVolume(DiscReader &reader)
+        : m_reader(reader)
+    {
+    }
+
+    Solid::OpticalDisc::ContentType probe();
+
+private:
+    bool readVolumeDescriptors();
+    bool resolveMetadataPartition(int reference, quint32 metadataFile);
+    QByteArray readBlocks(int reference, quint32 block, qint64 size);
+    QByteArray directoryData(const QByteArray &fileEntry, int reference);
+    qint64 partitionStart(quint16 number) const;
+
+    DiscReader &m_reader;
+    quint32 m_blockSize = s_sectorSize;
+    // start, in blocks, of the partitions by number
+    QList<std::pair<quint16, quint32>> m_partitions;
+    // start, in bytes, of the partitions by reference, as used in addresses
+    QList<qint64> m_references;
+    quint32 m_fileSetBlock = 0;
+    int m_fileSetReference = 0;
+};
+
+qint64 UdfVolume::partitionStart(quint16 number) const
+{
+    for (const auto &partition : m_partitions) {
+        if (partition.first == number) {
+            return partition.second;
+        }
+    }
+    return -1;
+}
+
+bool UdfVolume::readVolumeDescriptors()
+{
+    const QByteArray anchor = m_reader.read(s_anchorSector * s_sectorSize, s_sectorSize);
+    if (le16(anchor, 0) != s_tagAnchor) {
+        return false;
+    }
+
+    // Main volume descriptor sequence extent
+    const QByteArray sequence = m_reader.read(qint64(le32(anchor, 20)) * s_sectorSize, le32(anchor, 16));
+
+    QByteArray logicalVolume;
+    for (qsizetype offset = 0; offset + s_sectorSize <= sequence.size(); offset += s_sectorSize) {
+        const QByteArray descriptor = QByteArray::fromRawData(sequence.constData() + offset, s_sectorSize);
+        const quint16 tag = le16(descriptor, 0);
+        if (tag == s_tagPartition) {
+            m_partitions.append({le16(descriptor, 22), le32(descriptor, 188)});
+        } else if (tag == s_tagLogicalVolume) {
+            logicalVolume = QByteArray(descriptor.constData(), descriptor.size());
+        } else if (tag == s_tagTerminating) {
+            break;
+        }
+    }
+
+    if (logicalVolume.isEmpty() || m_partitions.isEmpty()) {
+        return false;
+    }
+
+    m_blockSize = le32(logicalVolume, 212);
+    if (m_blockSize == 0) {
+        return false;
+    }
+
+    // File set descriptor location, a long allocation descriptor
+    m_fileSetBlock = le32(logicalVolume, 252);
+    m_fileSetReference = le16(logicalVolume, 256);
+
+    // Partition maps, in reference order
+    const quint32 mapCount = le32(logicalVolume, 268);
+    qsizetype offset = 440;
+    QList<std::pair<quint16, quint32>> metadataMaps;
+    for (quint32 i = 0; i < mapCount && offset + 2 <= logicalVolume.size(); ++i) {
+        const quint8 type = byteAt(logicalVolume, offset);
+        const quint8 length = byteAt(logicalVolume, offset + 1);
+        if (length == 0) {
+            return false;
+        }
+
+        if (type == 1) {
+            m_references.append(partitionStart(le16(logicalVolume, offset + 4)) * m_blockSize);
+        } else if (type == 2) {
+            const QByteArray identifier = logicalVolume.mid(offset + 5, 23);
+            const quint16 number = le16(logicalVolume, offset + 38);
+            if (identifier.startsWith("*UDF Metadata Partition")) {
+                // Starts out as the physical partition, resolved below
+                metadataMaps.append({quint16(m_references.size()), le32(logicalVolume, offset + 40)});
+                m_references.append(partitionStart(number) * m_blockSize);
+            } else if (identifier.startsWith("*UDF Sparable Partition")) {
+                // Blocks are only relocated when they go bad
+                m_references.append(partitionStart(number) * m_blockSize);
+            } else {
+                // Virtual partitions of incrementally written discs
+                return false;
+            }
+        }
+
+        offset += length;
+    }
+
+    for (const auto &metadataMap : std::as_const(metadataMaps)) {
+        if (!resolveMetadataPartition(metadataMap.first, metadataMap.second)) {
+            return false;
+        }
+    }
+
+    return !m_references.isEmpty();
+}
+
+bool UdfVolume::resolveMetadataPartition(int reference, quint32 metadataFile)
+{
+    // The metadata partition is the content of the metadata file, stored in the
+    // physical partition. Mastering tools write it as a single extent.
+    const qint64 physicalStart = m_references.at(reference);
+    if (physicalStart < 0) {
+        return false;
+    }
+
+    const QByteArray fileEntry = m_reader.read(physicalStart + qint64(metadataFile) * m_blockSize, m_blockSize);
+
+    qsizetype adOffset;
+    if (le16(fileEntry, 0) == s_tagFileEntry) {
+        adOffset = 176 + le32(fileEntry, 168);
+    } else if (le16(fileEntry, 0) == s_tagExtendedFileEntry) {
+        adOffset = 216 + le32(fileEntry, 208);
+    } else {
+        return false;
+    }
+
+    // short allocation descriptor: length, then position in the partition
+    m_references[reference] = physicalStart + qint64(le32(fileEntry, adOffset + 4)) * m_blockSize;
+    return true;
+}
+
+QByteArray UdfVolume::readBlocks(int reference, quint32 block, qint64 size)
+{
+    if (reference < 0 || reference >= m_references.size() || m_references.at(reference) < 0) {
+        return QByteArray();
+    }
+    return m_reader.read(m_references.at(reference) + qint64(block) * m_blockSize, size);
+}
+
+QByteArray UdfVolume::directoryData(const QByteArray &fileEntry, int reference)
+{
+    quint32 extendedAttributesLength;
+    quint32 descriptorsLength;
+    qsizetype offset;
+    if (le16(fileEntry, 0) == s_tagFileEntry) {
+        extendedAttributesLength = le32(fileEntry, 168);
+        descriptorsLength = le32(fileEntry, 172);
+        offset = 176;
+    } else if (le16(fileEntry, 0) == s_tagExtendedFileEntry) {
+        extendedAttributesLength = le32(fileEntry, 208);
+        descriptorsLength = le32(fileEntry, 212);
+        offset = 216;
+    } else {
+        return QByteArray();
+    }
+    offset += extendedAttributesLength;
+
+    // Allocation type, in the flags of the ICB tag. Only the first extent is
+    // read, a root directory with a few entries doesn't span more.
+    switch (le16(fileEntry, 34) & 0x7) {
+    case 0: // short descriptors, in the partition of the entry
+        return readBlocks(reference, le32(fileEntry, offset + 4), le32(fileEntry, offset) & 0x3fffffff);
+    case 1: // long descriptors
+        return readBlocks(le16(fileEntry, offset + 8), le32(fileEntry, offset + 4), le32(fileEntry, offset) & 0x3fffffff);
+    case 3: // embedded in the entry
+        return fileEntry.mid(offset, descriptorsLength);
+    default:
+        return QByteArray();
+    }
+}
+
+Solid::OpticalDisc::ContentType UdfVolume::probe()
+{
+    if (!readVolumeDescriptors()) {
+        return Solid::OpticalDisc::NoContent;
+    }
+
+    const QByteArray fileSet = readBlocks(m_fileSetReference, m_fileSetBlock, m_blockSize);
+    if (le16(fileSet, 0) != s_tagFileSet) {
+        return Solid::OpticalDisc::NoContent;
+    }
+
+    // Root directory ICB, a long allocation descriptor
+    const int rootReference = le16(fileSet, 408);
+    const QByteArray rootEntry = readBlocks(rootReference, le32(fileSet, 404), m_blockSize);
+    const QByteArray directory = directoryData(rootEntry, rootReference);
+
+    // File identifier descriptors, padded to 4 bytes
+    qsizetype pos = 0;
+    while (pos + 38 <= directory.size() && le16(directory, pos) == s_tagFileIdentifier) {
+        const quint8 characteristics = byteAt(directory, pos + 18);
+        const quint8 identifierLength = byteAt(directory, pos + 19);
+        const quint16 implementationUseLength = le16(directory, pos + 36);
+        const qsizetype identifier = pos + 38 + implementationUseLength;
+        if (identifier + identifierLength > directory.size()) {
+            break;
+        }
+
+        // Directories other than the parent one, named in 8 or 16 bits
+        if ((characteristics & 0x02) && !(characteristics & 0x08) && identifierLength > 1) {
+            const quint8 compression = byteAt(directory, identifier);
+            QString name;
+            if (compression == 8) {
+                name = QString::fromLatin1(directory.constData() + identifier + 1, identifierLength - 1);
+            } else if (compression == 16) {
+                for (qsizetype i = identifier + 1; i + 1 < identifier + identifierLength; i += 2) {
+                    name.append(QChar(quint16(byteAt(directory, i) << 8 | byteAt(directory, i + 1))));
+                }
+            }
+
+            const auto content = contentOfDirectory(name);
+            if (content != Solid::OpticalDisc::NoContent) {
+                return content;
+            }
+        }
+
+        pos += (38 + implementationUseLength + identifierLength + 3) & ~3;
+    }
+
+    return Solid::OpticalDisc::NoContent;
+}
+}
+
+Solid::OpticalDisc::ContentType Solid::Backends::Shared::probeDiscContent(const QByteArray &deviceFile)
+{
+    DiscReader reader(deviceFile);
+    if (!reader.isOpen()) {
+        return Solid::OpticalDisc::NoContent;
+    }
+
+    const QByteArray descriptors = reader.read(s_descriptorsSector * s_sectorSize, s_descriptorsCount * s_sectorSize);
+
+    QByteArray primaryDescriptor;
+    bool udf = false;
+    for (qsizetype offset = 0; offset + s_sectorSize <= descriptors.size(); offset += s_sectorSize) {
+        const QByteArray identifier = descriptors.mid(offset + 1, 5);
+        if (identifier == "CD001") {
+            if (descriptors.at(offset) == 1 && primaryDescriptor.isEmpty()) {
+                primaryDescriptor = descriptors.mid(offset, s_sectorSize);
+            }
+        } else if (identifier == "NSR02" || identifier == "NSR03") {
+            udf = true;
+        } else if (identifier != "BEA01" && identifier != "TEA01" && identifier != "BOOT2" && identifier != "CDW02") {
+            break;
+        }
+    }
+
+    if (!primaryDescriptor.isEmpty()) {
+        const auto content = probeIso9660(reader, primaryDescriptor);
+        if (content != Solid::OpticalDisc::NoContent) {
+            return content;
+        }
+    }
+
+    if (udf) {
+        return UdfVolume(reader).probe();
+    }
+
+    return Solid::OpticalDisc::NoContent;
+}
@@ -0,0 +1,38 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef DISCPROBER_H
+#define DISCPROBER_H
+
+#include <solid/opticaldisc.h>
+
+#include <QByteArray>
+
+namespace Solid
+{
+namespace Backends
+{
+namespace Shared
+{
+/**
+ * Detects the video content of a disc from the top-level directories of its
+ * filesystem, found in the ISO 9660 path table or in the UDF root directory.
+ * UDF is only looked at when the ISO 9660 filesystem, if any, tells nothing,
+ * as on Blu-ray discs.
+ *
+ * Each structure is fetched with a single read: the volume descriptors, the
+ * path table, and for UDF the anchor, the volume descriptor sequence, the file
+ * set descriptor and the root directory.
+ *
+ * This blocks on the drive, don't call it from the GUI thread.
+ */
+Solid::OpticalDisc::ContentType probeDiscContent(const QByteArray &deviceFile);
+
+}
+}
+}
+
+#endif // DISCPROBER_H
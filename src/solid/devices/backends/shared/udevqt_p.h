@@ -12,21 +12,83 @@ extern "C" {
 #include <libudev.h>
 }
 
-class QByteArray;
+#include "udevqtclient.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
 class QSocketNotifier;
+class QThread;
+class QTimer;
 
 namespace UdevQt
 {
+/*
+ * Snapshot of the properties of a udev device, shared by all the copies of a
+ * Device. It is taken on first use into a single buffer holding every name and
+ * value, looked up by binary search without allocating; the QString values are
+ * only built, and decoded, the first time they are asked for.
+ */
+class DeviceProperties
+{
+public:
+    explicit DeviceProperties(struct udev_device *udev);
+
+    qsizetype indexOf(QByteArrayView name) const;
+    qsizetype indexOf(QStringView name) const;
+    QByteArrayView rawValue(qsizetype index) const;
+    QString value(qsizetype index) const;
+    QString decodedValue(qsizetype index) const;
+    QStringList names() const;
+
+private:
+    struct Entry {
+        qsizetype name;
+        qsizetype nameSize;
+        qsizetype value;
+        qsizetype valueSize;
+    };
+
+    void load() const;
+    QByteArrayView nameAt(qsizetype index) const;
+    template<typename Name>
+    qsizetype find(Name name) const;
+
+    struct udev_device *const m_udev; // kept alive by the DevicePrivates sharing this
+    mutable std::once_flag m_loaded;
+    mutable QByteArray m_data;
+    mutable QList<Entry> m_entries; // in libudev order
+    mutable QList<qsizetype> m_sorted; // entry indexes, sorted by name
+
+    mutable QMutex m_cacheMutex;
+    mutable std::vector<std::optional<QString>> m_values;
+    mutable std::vector<std::optional<QString>> m_decodedValues;
+    mutable std::optional<QStringList> m_names;
+};
+
 class DevicePrivate
 {
 public:
     DevicePrivate(struct udev_device *udev_, bool ref = true);
+    DevicePrivate(const DevicePrivate &other);
     ~DevicePrivate();
     DevicePrivate &operator=(const DevicePrivate &other);
 
-    QString decodePropertyValue(const QByteArray &encoded) const;
+    static QString decodePropertyValue(QByteArrayView encoded);
 
     struct udev_device *udev;
+    std::shared_ptr<DeviceProperties> properties;
 };
 
 class Client;
@@ -39,8 +101,27 @@ public:
     ~ClientPrivate();
 
     void init(const QStringList &subsystemList, ListenToWhat what);
+    using Clock = std::chrono::steady_clock;
+
+    // An event received by the monitor thread, waiting for the owner thread
+    struct QueuedEvent {
+        Device device;
+        QByteArray action;
+        Clock::time_point received;
+        QueuedEvent *next;
+    };
+
     void setWatchedSubsystems(const QStringList &subsystemList);
-    void dispatchEvent();
+    void startMonitoring();
+    void stopMonitoring();
+    void runMonitorThread(struct udev_monitor *monitor, int stopFd, const Client::EventFilter &filter);
+    void enqueueEvent(QueuedEvent *event);
+    void scheduleDrain();
+    void drainQueue();
+    void dispatchEvents();
+    void dispatchEvent(const Device &device, const QByteArray &action, Clock::time_point received);
+    void flushChange(const QByteArray &sysfsPath);
+    void flushChanges();
     DeviceList deviceListFromEnumerate(struct udev_enumerate *en);
 
     struct udev *udev;
@@ -48,6 +129,27 @@ public:
     Client *q;
     QSocketNotifier *monitorNotifier;
     QStringList watchedSubsystems;
+    int receiveBufferSize;
+    Client::EventFilter eventFilter;
+    Client::EventLatency eventLatency;
+
+    // The optional monitor thread, handing events over through a lock-free
+    // stack: it pushes, the owner thread takes everything at once. The stack
+    // is bounded, past that events are dropped and reported as such.
+    static const int maxQueuedEvents = 4096;
+    bool monitorThreadEnabled;
+    QThread *monitorThread;
+    int monitorThreadStopFd;
+    std::atomic<QueuedEvent *> queueHead;
+    std::atomic<int> queuedEvents;
+    std::atomic<bool> queueOverflowed;
+    std::atomic<bool> drainScheduled;
+
+    // change events held back for coalescing, latest one per device
+    QTimer *changeTimer;
+    int changeCoalescingInterval;
+    QHash<QByteArray, Device> pendingChanges;
+    QList<QByteArray> pendingChangeOrder;
 };
 
 inline QStringList listFromListEntry(struct udev_list_entry *list)
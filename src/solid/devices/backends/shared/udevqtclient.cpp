@@ -10,8 +10,17 @@
 #include "devices_debug.h"
 
 #include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
 #include <qplatformdefs.h>
 
+#include <algorithm>
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <utility>
+
 namespace UdevQt
 {
 ClientPrivate::ClientPrivate(Client *q_)
@@ -19,13 +28,29 @@ ClientPrivate::ClientPrivate(Client *q_)
     , monitor(nullptr)
     , q(q_)
     , monitorNotifier(nullptr)
+    , receiveBufferSize(0)
+    , changeTimer(nullptr)
+    , changeCoalescingInterval(0)
+    , monitorThreadEnabled(false)
+    , monitorThread(nullptr)
+    , monitorThreadStopFd(-1)
+    , queueHead(nullptr)
+    , queuedEvents(0)
+    , queueOverflowed(false)
+    , drainScheduled(false)
 {
 }
 
 ClientPrivate::~ClientPrivate()
 {
+    stopMonitoring();
+
+    QueuedEvent *event = queueHead.exchange(nullptr);
+    while (event) {
+        delete std::exchange(event, event->next);
+    }
+
     udev_unref(udev);
-    delete monitorNotifier;
 
     if (monitor) {
         udev_monitor_unref(monitor);
@@ -36,6 +61,12 @@ void ClientPrivate::init(const QStringList &subsystemList, ListenToWhat what)
 {
     udev = udev_new();
 
+    changeTimer = new QTimer(q);
+    changeTimer->setSingleShot(true);
+    QObject::connect(changeTimer, &QTimer::timeout, q, [this]() {
+        flushChanges();
+    });
+
     if (what != ListenToNone) {
         setWatchedSubsystems(subsystemList);
     }
@@ -64,38 +95,236 @@ void ClientPrivate::setWatchedSubsystems(const QStringList &subsystemList)
         }
     }
 
+    if (receiveBufferSize > 0 && udev_monitor_set_receive_buffer_size(newM, receiveBufferSize) < 0) {
+        qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: unable to set the receive buffer size to" << receiveBufferSize;
+    }
+
     // start the new monitor receiving
     udev_monitor_enable_receiving(newM);
-    QSocketNotifier *sn = new QSocketNotifier(udev_monitor_get_fd(newM), QSocketNotifier::Read);
-    QObject::connect(sn, &QSocketNotifier::activated, q, [this]() {
-        dispatchEvent();
-    });
 
     // kill any previous monitor
-    delete monitorNotifier;
+    stopMonitoring();
     if (monitor) {
         udev_monitor_unref(monitor);
     }
 
     // and save our new one
     monitor = newM;
-    monitorNotifier = sn;
     watchedSubsystems = subsystemList;
+    startMonitoring();
+}
+
+void ClientPrivate::startMonitoring()
+{
+    if (!monitor) {
+        return;
+    }
+
+    if (!monitorThreadEnabled) {
+        monitorNotifier = new QSocketNotifier(udev_monitor_get_fd(monitor), QSocketNotifier::Read);
+        QObject::connect(monitorNotifier, &QSocketNotifier::activated, q, [this]() {
+            dispatchEvents();
+        });
+        return;
+    }
+
+    monitorThreadStopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (monitorThreadStopFd < 0) {
+        qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: unable to create the monitor thread, monitoring from the owner thread";
+        monitorThreadEnabled = false;
+        startMonitoring();
+        return;
+    }
+
+    // The thread only gets copies, nothing it uses changes while it runs
+    monitorThread = QThread::create([this, mon = monitor, stopFd = monitorThreadStopFd, filter = eventFilter]() {
+        runMonitorThread(mon, stopFd, filter);
+    });
+    monitorThread->setObjectName(QStringLiteral("UdevQt monitor"));
+    monitorThread->start();
+}
+
+void ClientPrivate::stopMonitoring()
+{
+    delete monitorNotifier;
+    monitorNotifier = nullptr;
+
+    if (monitorThread) {
+        const quint64 one = 1;
+        if (write(monitorThreadStopFd, &one, sizeof(one)) != sizeof(one)) {
+            qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: unable to stop the monitor thread";
+        }
+        monitorThread->wait();
+        delete monitorThread;
+        monitorThread = nullptr;
+    }
+
+    if (monitorThreadStopFd >= 0) {
+        close(monitorThreadStopFd);
+        monitorThreadStopFd = -1;
+    }
+}
+
+void ClientPrivate::runMonitorThread(struct udev_monitor *mon, int stopFd, const Client::EventFilter &filter)
+{
+    struct pollfd fds[2] = {
+        {udev_monitor_get_fd(mon), POLLIN, 0},
+        {stopFd, POLLIN, 0},
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: polling the monitor failed, stopping the monitor thread";
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        if (!fds[0].revents) {
+            continue;
+        }
+
+        // Nothing else waits on this thread, drain everything pending
+        for (;;) {
+            errno = 0;
+            struct udev_device *dev = udev_monitor_receive_device(mon);
+            const Clock::time_point received = Clock::now();
+
+            if (!dev) {
+                if (errno == ENOBUFS) {
+                    queueOverflowed = true;
+                    scheduleDrain();
+                    continue;
+                }
+                break;
+            }
+
+            // The owner thread doesn't keep up, or has no event loop at all
+            if (queuedEvents.load(std::memory_order_relaxed) >= maxQueuedEvents) {
+                udev_device_unref(dev);
+                queueOverflowed = true;
+                continue;
+            }
+
+            auto *event = new QueuedEvent{Device(new DevicePrivate(dev, false)), QByteArray(udev_device_get_action(dev)), received, nullptr};
+            if (filter && !filter(event->device, event->action)) {
+                delete event;
+                continue;
+            }
+            enqueueEvent(event);
+        }
+    }
 }
 
-void ClientPrivate::dispatchEvent()
+void ClientPrivate::enqueueEvent(QueuedEvent *event)
 {
-    monitorNotifier->setEnabled(false);
-    struct udev_device *dev = udev_monitor_receive_device(monitor);
-    monitorNotifier->setEnabled(true);
+    event->next = queueHead.load(std::memory_order_relaxed);
+    while (!queueHead.compare_exchange_weak(event->next, event, std::memory_order_release, std::memory_order_relaxed)) { }
+    queuedEvents.fetch_add(1, std::memory_order_relaxed);
+
+    scheduleDrain();
+}
 
-    if (!dev) {
+void ClientPrivate::scheduleDrain()
+{
+    // Only one wake-up of the owner thread at a time, it takes everything
+    if (drainScheduled.exchange(true)) {
         return;
     }
 
-    Device device(new DevicePrivate(dev, false));
+    QMetaObject::invokeMethod(
+        q,
+        [this]() {
+            drainQueue();
+        },
+        Qt::QueuedConnection);
+}
+
+void ClientPrivate::drainQueue()
+{
+    // Anything pushed from now on schedules another drain
+    drainScheduled = false;
+    QueuedEvent *event = queueHead.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack holds the newest first
+    QueuedEvent *ordered = nullptr;
+    int count = 0;
+    while (event) {
+        QueuedEvent *next = event->next;
+        event->next = ordered;
+        ordered = event;
+        event = next;
+        ++count;
+    }
+    queuedEvents.fetch_sub(count, std::memory_order_relaxed);
+
+    while (ordered) {
+        const QueuedEvent *current = std::exchange(ordered, ordered->next);
+        dispatchEvent(current->device, current->action, current->received);
+        delete current;
+    }
+
+    // Reported after what did get through, the receiver re-enumerates anyway
+    if (queueOverflowed.exchange(false)) {
+        qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: receive buffer or event queue overflow, events were lost";
+        Q_EMIT q->eventsDropped();
+    }
+}
+
+void ClientPrivate::dispatchEvents()
+{
+    // The socket is non-blocking: drain what is pending, a bounded number of
+    // events at a time so a long burst doesn't starve the event loop. The
+    // notifier fires again for whatever is left.
+    static const int maxEventsPerWakeup = 256;
+
+    for (int i = 0; i < maxEventsPerWakeup && monitor; ++i) {
+        errno = 0;
+        struct udev_device *dev = udev_monitor_receive_device(monitor);
+        const Clock::time_point received = Clock::now();
+
+        if (!dev) {
+            if (errno == ENOBUFS) {
+                qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: receive buffer overflow, events were lost";
+                Q_EMIT q->eventsDropped();
+                continue;
+            }
+            break;
+        }
+
+        Device device(new DevicePrivate(dev, false));
+        const QByteArray action(udev_device_get_action(dev));
+        if (!eventFilter || eventFilter(device, action)) {
+            dispatchEvent(device, action, received);
+        }
+    }
+}
+
+void ClientPrivate::dispatchEvent(const Device &device, const QByteArray &action, Clock::time_point received)
+{
+    const QByteArray sysfsPath(udev_device_get_syspath(device.udevDevice()));
+
+    if (action == "change" && changeCoalescingInterval > 0) {
+        if (!pendingChanges.contains(sysfsPath)) {
+            pendingChangeOrder.append(sysfsPath);
+        }
+        pendingChanges.insert(sysfsPath, device);
+        if (!changeTimer->isActive()) {
+            changeTimer->start(changeCoalescingInterval);
+        }
+        return;
+    }
+
+    flushChange(sysfsPath);
+
+    const qint64 latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - received).count();
+    eventLatency.last = latency;
+    eventLatency.maximum = std::max(eventLatency.maximum, latency);
+    ++eventLatency.count;
 
-    QByteArray action(udev_device_get_action(dev));
     if (action == "add") {
         Q_EMIT q->deviceAdded(device);
     } else if (action == "remove") {
@@ -115,6 +344,30 @@ void ClientPrivate::dispatchEvent()
     }
 }
 
+void ClientPrivate::flushChange(const QByteArray &sysfsPath)
+{
+    const auto it = pendingChanges.constFind(sysfsPath);
+    if (it == pendingChanges.constEnd()) {
+        return;
+    }
+
+    const Device device = it.value();
+    pendingChanges.erase(it);
+    pendingChangeOrder.removeOne(sysfsPath);
+    Q_EMIT q->deviceChanged(device);
+}
+
+void ClientPrivate::flushChanges()
+{
+    // Take them out first, a receiver may well change the client
+    const QList<QByteArray> order = std::exchange(pendingChangeOrder, {});
+    QHash<QByteArray, Device> changes = std::exchange(pendingChanges, {});
+
+    for (const QByteArray &sysfsPath : order) {
+        Q_EMIT q->deviceChanged(changes.value(sysfsPath));
+    }
+}
+
 DeviceList ClientPrivate::deviceListFromEnumerate(struct udev_enumerate *en)
 {
     DeviceList ret;
@@ -184,6 +437,59 @@ void Client::setWatchedSubsystems(const QStringList &subsystemList)
     d->setWatchedSubsystems(subsystemList);
 }
 
+void Client::setReceiveBufferSize(int bytes)
+{
+    d->receiveBufferSize = bytes;
+    if (d->monitor && bytes > 0 && udev_monitor_set_receive_buffer_size(d->monitor, bytes) < 0) {
+        qCWarning(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "UdevQt: unable to set the receive buffer size to" << bytes;
+    }
+}
+
+int Client::receiveBufferSize() const
+{
+    return d->receiveBufferSize;
+}
+
+void Client::setChangeCoalescingInterval(int msec)
+{
+    d->changeCoalescingInterval = msec;
+    if (msec <= 0) {
+        d->changeTimer->stop();
+        d->flushChanges();
+    }
+}
+
+int Client::changeCoalescingInterval() const
+{
+    return d->changeCoalescingInterval;
+}
+
+void Client::setEventFilter(const EventFilter &filter)
+{
+    d->eventFilter = filter;
+}
+
+void Client::setMonitorThreadEnabled(bool enabled)
+{
+    if (d->monitorThreadEnabled == enabled) {
+        return;
+    }
+
+    d->stopMonitoring();
+    d->monitorThreadEnabled = enabled;
+    d->startMonitoring();
+}
+
+bool Client::isMonitorThreadEnabled() const
+{
+    return d->monitorThreadEnabled;
+}
+
+Client::EventLatency Client::eventLatency() const
+{
+    return d->eventLatency;
+}
+
 DeviceList Client::devicesByProperty(const QString &property, const QVariant &value)
 {
     struct udev_enumerate *en = udev_enumerate_new(d->udev);
@@ -14,6 +14,8 @@
 
 #include "udevqtdevice.h"
 
+#include <functional>
+
 namespace UdevQt
 {
 class ClientPrivate;
@@ -24,6 +26,23 @@ class Client : public QObject
     Q_PROPERTY(QStringList watchedSubsystems READ watchedSubsystems WRITE setWatchedSubsystems)
 
 public:
+    /**
+     * Decides, from the device and the action of an event, whether it is
+     * emitted at all. Runs on the monitor thread when there is one.
+     */
+    using EventFilter = std::function<bool(const Device &device, const QByteArray &action)>;
+
+    /**
+     * Time from the reception of events on the monitor socket to the
+     * emission of their signal, in nanoseconds. Coalesced change events,
+     * delayed on purpose, are not accounted.
+     */
+    struct EventLatency {
+        qint64 last = 0;
+        qint64 maximum = 0;
+        quint64 count = 0;
+    };
+
     Client(QObject *parent = nullptr);
     Client(const QStringList &subsystemList, QObject *parent = nullptr);
     ~Client() override;
@@ -31,6 +50,44 @@ public:
     QStringList watchedSubsystems() const;
     void setWatchedSubsystems(const QStringList &subsystemList);
 
+    /**
+     * Sets the size in bytes of the kernel receive buffer of the monitor, so
+     * that bursts of events are not dropped before they get read.
+     * 0, the default, keeps the system default.
+     */
+    void setReceiveBufferSize(int bytes);
+    int receiveBufferSize() const;
+
+    /**
+     * Holds back change events for up to @p msec, only emitting the latest
+     * change of each device. Other events for a device first flush its held
+     * back change, so the order per device is kept.
+     * 0, the default, emits every change event as it arrives.
+     */
+    void setChangeCoalescingInterval(int msec);
+    int changeCoalescingInterval() const;
+
+    /**
+     * Only emits the events accepted by @p filter, which must be thread-safe
+     * when the monitor thread is enabled. It is taken into account when the
+     * monitor (re)starts, so set it before the subsystems to watch or before
+     * enabling the thread.
+     */
+    void setEventFilter(const EventFilter &filter);
+
+    /**
+     * Services the monitor socket, and runs the event filter, on a dedicated
+     * thread instead of the thread of this object. The events are handed
+     * over without locking, and the signals are still emitted from the
+     * thread of this object, which needs a running event loop. At most 4096
+     * events wait for it, the ones past that are dropped and eventsDropped()
+     * is emitted.
+     */
+    void setMonitorThreadEnabled(bool enabled);
+    bool isMonitorThreadEnabled() const;
+
+    EventLatency eventLatency() const;
+
     DeviceList allDevices();
     DeviceList devicesByProperty(const QString &property, const QVariant &value);
     DeviceList devicesBySubsystem(const QString &subsystem);
@@ -53,6 +110,13 @@ Q_SIGNALS:
     void deviceBound(const UdevQt::Device &dev);
     void deviceUnbound(const UdevQt::Device &dev);
 
+    /**
+     * The kernel receive buffer, or the queue of the monitor thread,
+     * overflowed and events got lost: anything kept about the watched
+     * devices must be refreshed from an enumeration.
+     */
+    void eventsDropped();
+
 private:
     friend class ClientPrivate;
     ClientPrivate *d;
@@ -8,35 +8,176 @@
 #include "udevqt_p.h"
 
 #include <QByteArray>
+#include <QMutexLocker>
+
+#include <algorithm>
 
 namespace UdevQt
 {
+DeviceProperties::DeviceProperties(struct udev_device *udev)
+    : m_udev(udev)
+{
+}
+
+void DeviceProperties::load() const
+{
+    std::call_once(m_loaded, [this]() {
+        struct udev_list_entry *entry;
+
+        qsizetype count = 0;
+        qsizetype size = 0;
+        udev_list_entry_foreach(entry, udev_device_get_properties_list_entry(m_udev))
+        {
+            size += qstrlen(udev_list_entry_get_name(entry)) + qstrlen(udev_list_entry_get_value(entry)) + 2;
+            ++count;
+        }
+
+        m_data.reserve(size);
+        m_entries.reserve(count);
+        udev_list_entry_foreach(entry, udev_device_get_properties_list_entry(m_udev))
+        {
+            const QByteArrayView name(udev_list_entry_get_name(entry));
+            const QByteArrayView value(udev_list_entry_get_value(entry));
+            Entry e{m_data.size(), name.size(), 0, value.size()};
+            m_data.append(name).append('\0');
+            e.value = m_data.size();
+            m_data.append(value).append('\0');
+            m_entries.append(e);
+        }
+
+        m_sorted.reserve(m_entries.size());
+        for (qsizetype i = 0; i < m_entries.size(); ++i) {
+            m_sorted.append(i);
+        }
+        std::sort(m_sorted.begin(), m_sorted.end(), [this](qsizetype a, qsizetype b) {
+            return nameAt(a).compare(nameAt(b)) < 0;
+        });
+
+        m_values.resize(m_entries.size());
+        m_decodedValues.resize(m_entries.size());
+    });
+}
+
+QByteArrayView DeviceProperties::nameAt(qsizetype index) const
+{
+    const Entry &entry = m_entries.at(index);
+    return QByteArrayView(m_data.constData() + entry.name, entry.nameSize);
+}
+
+static int compareName(QByteArrayView name, QByteArrayView key)
+{
+    return name.compare(key);
+}
+
+static int compareName(QByteArrayView name, QStringView key)
+{
+    // Property names are ASCII, this orders them the same as the bytes
+    return QLatin1StringView(name).compare(key);
+}
+
+template<typename Name>
+qsizetype DeviceProperties::find(Name name) const
+{
+    load();
+
+    const auto it = std::lower_bound(m_sorted.cbegin(), m_sorted.cend(), name, [this](qsizetype index, Name key) {
+        return compareName(nameAt(index), key) < 0;
+    });
+    if (it == m_sorted.cend() || compareName(nameAt(*it), name) != 0) {
+        return -1;
+    }
+    return *it;
+}
+
+qsizetype DeviceProperties::indexOf(QByteArrayView name) const
+{
+    return find(name);
+}
+
+qsizetype DeviceProperties::indexOf(QStringView name) const
+{
+    return find(name);
+}
+
+QByteArrayView DeviceProperties::rawValue(qsizetype index) const
+{
+    const Entry &entry = m_entries.at(index);
+    return QByteArrayView(m_data.constData() + entry.value, entry.valueSize);
+}
+
+QString DeviceProperties::value(qsizetype index) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    std::optional<QString> &value = m_values[index];
+    if (!value) {
+        value = QString::fromLatin1(rawValue(index));
+    }
+    return *value;
+}
+
+QString DeviceProperties::decodedValue(qsizetype index) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    std::optional<QString> &value = m_decodedValues[index];
+    if (!value) {
+        value = DevicePrivate::decodePropertyValue(rawValue(index));
+    }
+    return *value;
+}
+
+QStringList DeviceProperties::names() const
+{
+    load();
+
+    QMutexLocker locker(&m_cacheMutex);
+    if (!m_names) {
+        QStringList names;
+        names.reserve(m_entries.size());
+        for (qsizetype i = 0; i < m_entries.size(); ++i) {
+            names.append(QString::fromLatin1(nameAt(i)));
+        }
+        m_names = names;
+    }
+    return *m_names;
+}
+
 DevicePrivate::DevicePrivate(struct udev_device *udev_, bool ref)
     : udev(udev_)
+    , properties(std::make_shared<DeviceProperties>(udev_))
 {
     if (ref) {
         udev_device_ref(udev);
     }
 }
 
+DevicePrivate::DevicePrivate(const DevicePrivate &other)
+    : udev(udev_device_ref(other.udev))
+    , properties(other.properties)
+{
+}
+
 DevicePrivate::~DevicePrivate()
 {
+    // The properties may point to the udev device, let go of them first
+    properties.reset();
     udev_device_unref(udev);
 }
 
 DevicePrivate &DevicePrivate::operator=(const DevicePrivate &other)
 {
-    udev_device_unref(udev);
+    struct udev_device *previous = udev;
     udev = udev_device_ref(other.udev);
+    properties = other.properties;
+    udev_device_unref(previous);
     return *this;
 }
 
-QString DevicePrivate::decodePropertyValue(const QByteArray &encoded) const
+QString DevicePrivate::decodePropertyValue(QByteArrayView encoded)
 {
     QByteArray decoded;
-    const int len = encoded.length();
+    const qsizetype len = encoded.length();
 
-    for (int i = 0; i < len; i++) {
+    for (qsizetype i = 0; i < len; i++) {
         quint8 ch = encoded.at(i);
 
         if (ch == '\\') {
@@ -45,7 +186,7 @@ QString DevicePrivate::decodePropertyValue(const QByteArray &encoded) const
                 i++;
                 continue;
             } else if (i + 3 < len && encoded.at(i + 1) == 'x') {
-                QByteArray hex = encoded.mid(i + 2, 2);
+                QByteArrayView hex = encoded.mid(i + 2, 2);
                 bool ok;
                 int code = hex.toInt(&ok, 16);
                 if (ok) {
@@ -69,7 +210,7 @@ Device::Device()
 Device::Device(const Device &other)
 {
     if (other.d) {
-        d = new DevicePrivate(other.d->udev);
+        d = new DevicePrivate(*other.d);
     } else {
         d = nullptr;
     }
@@ -96,7 +237,7 @@ Device &Device::operator=(const Device &other)
         return *this;
     }
     if (!d) {
-        d = new DevicePrivate(other.d->udev);
+        d = new DevicePrivate(*other.d);
     } else {
         *d = *other.d;
     }
@@ -193,7 +334,7 @@ QStringList Device::deviceProperties() const
         return QStringList();
     }
 
-    return listFromListEntry(udev_device_get_properties_list_entry(d->udev));
+    return d->properties->names();
 }
 
 #ifdef UDEV_HAVE_GET_SYSATTR_LIST_ENTRY
@@ -207,6 +348,11 @@ QStringList Device::sysfsProperties() const
 }
 #endif
 
+struct udev_device *Device::udevDevice() const
+{
+    return d ? d->udev : nullptr;
+}
+
 Device Device::parent() const
 {
     if (!d) {
@@ -228,12 +374,24 @@ QVariant Device::deviceProperty(const QString &name) const
         return QVariant();
     }
 
-    QByteArray propName = name.toLatin1();
-    QString propValue = QString::fromLatin1(udev_device_get_property_value(d->udev, propName.constData()));
-    if (!propValue.isEmpty()) {
-        return QVariant::fromValue(propValue);
+    const qsizetype index = d->properties->indexOf(QStringView(name));
+    if (index < 0 || d->properties->rawValue(index).isEmpty()) {
+        return QVariant();
     }
-    return QVariant();
+    return QVariant::fromValue(d->properties->value(index));
+}
+
+QVariant Device::deviceProperty(QLatin1StringView name) const
+{
+    if (!d) {
+        return QVariant();
+    }
+
+    const qsizetype index = d->properties->indexOf(QByteArrayView(name.data(), name.size()));
+    if (index < 0 || d->properties->rawValue(index).isEmpty()) {
+        return QVariant();
+    }
+    return QVariant::fromValue(d->properties->value(index));
 }
 
 QString Device::decodedDeviceProperty(const QString &name) const
@@ -242,8 +400,28 @@ QString Device::decodedDeviceProperty(const QString &name) const
         return QString();
     }
 
-    QByteArray propName = name.toLatin1();
-    return d->decodePropertyValue(udev_device_get_property_value(d->udev, propName.constData()));
+    const qsizetype index = d->properties->indexOf(QStringView(name));
+    return index < 0 ? QString() : d->properties->decodedValue(index);
+}
+
+QString Device::decodedDeviceProperty(QLatin1StringView name) const
+{
+    if (!d) {
+        return QString();
+    }
+
+    const qsizetype index = d->properties->indexOf(QByteArrayView(name.data(), name.size()));
+    return index < 0 ? QString() : d->properties->decodedValue(index);
+}
+
+QByteArrayView Device::rawDeviceProperty(QByteArrayView name) const
+{
+    if (!d) {
+        return QByteArrayView();
+    }
+
+    const qsizetype index = d->properties->indexOf(name);
+    return index < 0 ? QByteArrayView() : d->properties->rawValue(index);
 }
 
 QVariant Device::sysfsProperty(const QString &name) const
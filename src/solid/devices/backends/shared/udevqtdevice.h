@@ -7,11 +7,15 @@
 #ifndef UDEVQTDEVICE_H
 #define UDEVQTDEVICE_H
 
+#include <QByteArrayView>
+#include <QLatin1StringView>
 #include <QList>
 #include <QString>
 #include <QStringList>
 #include <QVariant>
 
+struct udev_device;
+
 namespace UdevQt
 {
 class DevicePrivate;
@@ -41,10 +45,17 @@ public:
     // ### should this really be a QVariant? as far as udev knows, everything is a string...
     // see also Client::devicesByProperty
     QVariant deviceProperty(const QString &name) const;
+    QVariant deviceProperty(QLatin1StringView name) const;
     QString decodedDeviceProperty(const QString &name) const;
+    QString decodedDeviceProperty(QLatin1StringView name) const;
+    // The raw value, valid as long as this device; empty when the property is not set
+    QByteArrayView rawDeviceProperty(QByteArrayView name) const;
     QVariant sysfsProperty(const QString &name) const;
     Device ancestorOfType(const QString &subsys, const QString &devtype) const;
 
+    // The underlying libudev device, owned by this object
+    struct udev_device *udevDevice() const;
+
 private:
     Device(DevicePrivate *devPrivate);
     friend class Client;
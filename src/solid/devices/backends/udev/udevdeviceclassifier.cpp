@@ -0,0 +1,221 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "udevdeviceclassifier.h"
+
+#include "../shared/udevqt_p.h"
+
+#include <QVarLengthArray>
+
+#include <iterator>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace Solid::Backends::UDev;
+
+namespace
+{
+enum class Match {
+    Always, // the subsystem alone is enough
+    CpuPresent, // a processor slot with a processor in it
+    HardwareTty, // a tty device node which is not virtual
+    PropertyDiffers, // the property is missing or differs from the value
+    AnyPropertyIsOne,
+    PropertySetNotOnParent,
+    PropertyIsOneNotOnParent,
+};
+
+struct Rule {
+    const char *subsystem; // nullptr for any subsystem
+    Match match;
+    const char *properties[5];
+    const char *value;
+    bool decisive; // the outcome of the rule is the answer, matching or not
+};
+
+// Evaluated in order, the first matching rule makes the device of interest
+const Rule s_rules[] = {
+    // Linux ACPI reports processor slots, rather than processors.
+    // Empty slots will not have a system device associated with them.
+    {"cpu", Match::CpuPresent, {}, nullptr, true},
+    {"sound", Match::PropertyDiffers, {"SOUND_FORM_FACTOR"}, "internal", false},
+    {"tty", Match::HardwareTty, {"DEVPATH"}, nullptr, false},
+    {"input",
+     Match::AnyPropertyIsOne,
+     {"ID_INPUT_MOUSE", "ID_INPUT_TOUCHPAD", "ID_INPUT_TABLET", "ID_INPUT_JOYSTICK", "ID_INPUT_TOUCHSCREEN"},
+     nullptr,
+     false},
+    {"dvb", Match::Always, {}, nullptr, false},
+    {"net", Match::Always, {}, nullptr, false},
+    // media-player-info recognized devices
+    {nullptr, Match::PropertySetNotOnParent, {"ID_MEDIA_PLAYER"}, nullptr, false},
+    // GPhoto2 cameras
+    {nullptr, Match::PropertyIsOneNotOnParent, {"ID_GPHOTO2"}, nullptr, false},
+};
+
+int propertyCount(const Rule &rule)
+{
+    int count = 0;
+    while (count < int(std::size(rule.properties)) && rule.properties[count]) {
+        ++count;
+    }
+    return count;
+}
+
+bool isSet(const char *value)
+{
+    return value && *value;
+}
+
+// The same as QVariant(QString).toInt() == 1
+bool isOne(const char *value)
+{
+    return value && QByteArray::fromRawData(value, qstrlen(value)).toInt() == 1;
+}
+
+bool startsWith(const char *value, const char *prefix)
+{
+    return strncmp(value, prefix, strlen(prefix)) == 0;
+}
+
+bool cpuPresent(struct udev_device *device)
+{
+    const QByteArray path(udev_device_get_syspath(device));
+    for (const char *entry : {"/sysdev", "/cpufreq", "/topology/core_id"}) {
+        if (access((path + entry).constData(), F_OK) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hardwareTty(const char *devPath)
+{
+    if (!devPath) {
+        return false;
+    }
+    const char *slash = strrchr(devPath, '/');
+    const char *name = slash ? slash + 1 : devPath;
+    return startsWith(name, "tty") && !startsWith(devPath, "/devices/virtual");
+}
+
+bool evaluate(const Rule &rule, struct udev_device *device, const char *const *values)
+{
+    switch (rule.match) {
+    case Match::Always:
+        return true;
+    case Match::CpuPresent:
+        return cpuPresent(device);
+    case Match::HardwareTty:
+        return hardwareTty(values[0]);
+    case Match::PropertyDiffers:
+        return !values[0] || strcmp(values[0], rule.value) != 0;
+    case Match::AnyPropertyIsOne:
+        for (int i = 0; i < propertyCount(rule); ++i) {
+            if (isOne(values[i])) {
+                return true;
+            }
+        }
+        return false;
+    case Match::PropertySetNotOnParent:
+        if (isSet(values[0])) {
+            struct udev_device *parent = udev_device_get_parent(device);
+            return !parent || !isSet(udev_device_get_property_value(parent, rule.properties[0]));
+        }
+        return false;
+    case Match::PropertyIsOneNotOnParent:
+        if (isOne(values[0])) {
+            struct udev_device *parent = udev_device_get_parent(device);
+            return !parent || !isOne(udev_device_get_property_value(parent, rule.properties[0]));
+        }
+        return false;
+    }
+    return false;
+}
+}
+
+const DeviceClassifier &DeviceClassifier::instance()
+{
+    static const DeviceClassifier classifier;
+    return classifier;
+}
+
+DeviceClassifier::DeviceClassifier()
+{
+    const int ruleCount = int(std::size(s_rules));
+
+    // Rules for a given subsystem come first, then the ones for any subsystem
+    for (int i = 0; i < ruleCount; ++i) {
+        if (s_rules[i].subsystem) {
+            append(m_bySubsystem[QByteArray(s_rules[i].subsystem)], i);
+        }
+    }
+    for (int i = 0; i < ruleCount; ++i) {
+        if (s_rules[i].subsystem) {
+            continue;
+        }
+        append(m_anySubsystem, i);
+        for (auto it = m_bySubsystem.begin(); it != m_bySubsystem.end(); ++it) {
+            append(it.value(), i);
+        }
+    }
+}
+
+void DeviceClassifier::append(CompiledRules &compiled, int rule) const
+{
+    compiled.rules.append(CompiledRule{rule, int(compiled.properties.size())});
+    for (int i = 0; i < propertyCount(s_rules[rule]); ++i) {
+        compiled.properties.append(s_rules[rule].properties[i]);
+    }
+}
+
+bool DeviceClassifier::isOfInterest(const UdevQt::Device &device) const
+{
+    return isOfInterest(device.udevDevice());
+}
+
+bool DeviceClassifier::isOfInterest(struct udev_device *device) const
+{
+    if (!device) {
+        return false;
+    }
+
+    const CompiledRules *compiled = &m_anySubsystem;
+    if (const char *subsystem = udev_device_get_subsystem(device)) {
+        const auto it = m_bySubsystem.constFind(QByteArray::fromRawData(subsystem, qstrlen(subsystem)));
+        if (it != m_bySubsystem.constEnd()) {
+            compiled = &it.value();
+        }
+    }
+
+    // Pick the values all the rules need in one walk over the property list
+    const qsizetype wanted = compiled->properties.size();
+    QVarLengthArray<const char *, 16> values(wanted, nullptr);
+    qsizetype found = 0;
+    struct udev_list_entry *entry;
+    udev_list_entry_foreach(entry, udev_device_get_properties_list_entry(device))
+    {
+        if (found == wanted) {
+            break;
+        }
+        const char *name = udev_list_entry_get_name(entry);
+        for (qsizetype i = 0; i < wanted; ++i) {
+            if (!values[i] && strcmp(name, compiled->properties[i]) == 0) {
+                values[i] = udev_list_entry_get_value(entry);
+                ++found;
+            }
+        }
+    }
+
+    for (const CompiledRule &rule : compiled->rules) {
+        const bool matches = evaluate(s_rules[rule.rule], device, values.constData() + rule.firstValue);
+        if (matches || s_rules[rule.rule].decisive) {
+            return matches;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_BACKENDS_UDEV_UDEVDEVICECLASSIFIER_H
+#define SOLID_BACKENDS_UDEV_UDEVDEVICECLASSIFIER_H
+
+#include "../shared/udevqt.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+struct udev_device;
+
+namespace Solid
+{
+namespace Backends
+{
+namespace UDev
+{
+/**
+ * Decides which udev devices are exposed by the backend.
+ *
+ * The rules are declared in a static table, compiled once into a list per
+ * subsystem, and evaluated on the raw libudev property list: each device costs
+ * a single walk over its properties and no QString or QVariant conversion.
+ */
+class DeviceClassifier
+{
+public:
+    static const DeviceClassifier &instance();
+
+    bool isOfInterest(const UdevQt::Device &device) const;
+    bool isOfInterest(struct udev_device *device) const;
+
+private:
+    DeviceClassifier();
+
+    struct CompiledRule {
+        int rule; // index in the rule table
+        int firstValue; // index of its first property in the collected values
+    };
+    struct CompiledRules {
+        QList<CompiledRule> rules;
+        QList<const char *> properties; // the properties the rules look at
+    };
+
+    void append(CompiledRules &compiled, int rule) const;
+
+    QHash<QByteArray, CompiledRules> m_bySubsystem;
+    CompiledRules m_anySubsystem;
+};
+}
+}
+}
+
+#endif // SOLID_BACKENDS_UDEV_UDEVDEVICECLASSIFIER_H
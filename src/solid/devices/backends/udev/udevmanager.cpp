@@ -9,10 +9,16 @@
 #include "../shared/rootdevice.h"
 #include "udev.h"
 #include "udevdevice.h"
+#include "udevdeviceclassifier.h"
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QHash>
 #include <QSet>
+#include <QThread>
+
+#include <utility>
 
 using namespace Solid::Backends::UDev;
 using namespace Solid::Backends::Shared;
@@ -26,8 +32,27 @@ public:
     bool isOfInterest(const QString &udi, const UdevQt::Device &device);
     bool checkOfInterest(const UdevQt::Device &device);
 
+    void seedDeviceTree();
+    void insertDevice(const QString &udi, const UdevQt::Device &device);
+    bool removeDevice(const QString &udi);
+
+    struct Node {
+        UdevQt::Device device;
+        QString parentUdi;
+    };
+
     UdevQt::Client *m_client;
-    QStringList m_devicesOfInterest;
+    // Devices of interest, keyed by UDI (the prefixed sysfs path), seeded by a
+    // single enumeration and then kept current by the monitor events
+    QHash<QString, Node> m_deviceTree;
+    // UDIs of m_deviceTree in enumeration order, new devices last
+    QStringList m_deviceOrder;
+    QHash<QString, QStringList> m_children;
+    bool m_deviceTreeSeeded = false;
+    // Devices known not to be of interest; only kept for the watched
+    // subsystems, whose events tell when that has to be looked at again
+    QSet<QString> m_notOfInterest;
+    QSet<QString> m_watchedSubsystems;
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
 };
 
@@ -44,6 +69,22 @@ UDevManager::Private::Private()
         QStringLiteral("input"),
     };
     m_client = new UdevQt::Client(subsystems);
+
+    // Every thread querying devices gets a manager of its own, only the one of
+    // the main thread, whose event loop runs for the whole application, sets
+    // up for the bursts of hotplugging a hub or running udevadm trigger
+    const QCoreApplication *app = QCoreApplication::instance();
+    if (app && app->thread() == QThread::currentThread()) {
+        m_client->setReceiveBufferSize(8 * 1024 * 1024);
+        m_client->setChangeCoalescingInterval(100);
+        // Additions of devices which aren't of interest can't change anything
+        // for us, drop them right on the monitor thread
+        m_client->setEventFilter([](const UdevQt::Device &device, const QByteArray &action) {
+            return action != "add" || DeviceClassifier::instance().isOfInterest(device);
+        });
+        m_client->setMonitorThreadEnabled(true);
+    }
+    m_watchedSubsystems = QSet<QString>(subsystems.cbegin(), subsystems.cend());
 }
 
 UDevManager::Private::~Private()
@@ -53,22 +94,75 @@ UDevManager::Private::~Private()
 
 bool UDevManager::Private::isOfInterest(const QString &udi, const UdevQt::Device &device)
 {
-    if (m_devicesOfInterest.contains(udi)) {
+    if (m_deviceTree.contains(udi)) {
         return true;
     }
+    if (m_notOfInterest.contains(udi)) {
+        return false;
+    }
 
     bool isOfInterest = checkOfInterest(device);
     if (isOfInterest) {
-        m_devicesOfInterest.append(udi);
+        insertDevice(udi, device);
+    } else if (m_watchedSubsystems.contains(device.subsystem())) {
+        m_notOfInterest.insert(udi);
     }
 
     return isOfInterest;
 }
 
+void UDevManager::Private::seedDeviceTree()
+{
+    if (m_deviceTreeSeeded) {
+        return;
+    }
+    m_deviceTreeSeeded = true;
+
+    const QString prefix = QStringLiteral(UDEV_UDI_PREFIX);
+    const UdevQt::DeviceList deviceList = m_client->allDevices();
+    for (const UdevQt::Device &device : deviceList) {
+        isOfInterest(prefix + device.sysfsPath(), device);
+    }
+}
+
+void UDevManager::Private::insertDevice(const QString &udi, const UdevQt::Device &device)
+{
+    auto it = m_deviceTree.find(udi);
+    if (it != m_deviceTree.end()) {
+        // A newer snapshot of the same device, its place in the tree does not change
+        it->device = device;
+        return;
+    }
+
+    const QString parentUdi = UDevDevice(device).parentUdi();
+    m_deviceTree.insert(udi, Node{device, parentUdi});
+    m_deviceOrder.append(udi);
+    m_children[parentUdi].append(udi);
+}
+
+bool UDevManager::Private::removeDevice(const QString &udi)
+{
+    const auto it = m_deviceTree.constFind(udi);
+    if (it == m_deviceTree.constEnd()) {
+        return false;
+    }
+
+    auto children = m_children.find(it->parentUdi);
+    if (children != m_children.end()) {
+        children->removeOne(udi);
+        if (children->isEmpty()) {
+            m_children.erase(children);
+        }
+    }
+    m_deviceTree.erase(it);
+    m_deviceOrder.removeOne(udi);
+    return true;
+}
+
 bool UDevManager::Private::checkOfInterest(const UdevQt::Device &device)
 {
-    const QString subsystem = device.subsystem();
 #ifdef UDEV_DETAILED_OUTPUT
+    const QString subsystem = device.subsystem();
     qDebug() << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<";
     qDebug() << "Path:" << device.sysfsPath();
     qDebug() << "Properties:" << device.deviceProperties();
@@ -82,47 +176,7 @@ bool UDevManager::Private::checkOfInterest(const UdevQt::Device &device)
     qDebug() << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>";
 #endif
 
-    if (subsystem == QLatin1String("cpu")) {
-        // Linux ACPI reports processor slots, rather than processors.
-        // Empty slots will not have a system device associated with them.
-        return QFile::exists(device.sysfsPath() + QStringLiteral("/sysdev")) //
-            || QFile::exists(device.sysfsPath() + QStringLiteral("/cpufreq")) //
-            || QFile::exists(device.sysfsPath() + QStringLiteral("/topology/core_id"));
-    }
-    if (subsystem == QLatin1String("sound") && device.deviceProperty(QStringLiteral("SOUND_FORM_FACTOR")).toString() != QStringLiteral("internal")) {
-        return true;
-    }
-
-    if (subsystem == QLatin1String("tty")) {
-        QString path = device.deviceProperty(QStringLiteral("DEVPATH")).toString();
-
-        int lastSlash = path.length() - path.lastIndexOf(QLatin1String("/")) - 1;
-        QByteArray lastElement = path.right(lastSlash).toLatin1();
-
-        if (lastElement.startsWith("tty") && !path.startsWith(QStringLiteral("/devices/virtual"))) {
-            return true;
-        }
-    }
-
-    if (subsystem == QLatin1String("input")) {
-        /* clang-format off */
-        if (device.deviceProperty(QStringLiteral("ID_INPUT_MOUSE")).toInt() == 1
-            || device.deviceProperty(QStringLiteral("ID_INPUT_TOUCHPAD")).toInt() == 1
-            || device.deviceProperty(QStringLiteral("ID_INPUT_TABLET")).toInt() == 1
-            || device.deviceProperty(QStringLiteral("ID_INPUT_JOYSTICK")).toInt() == 1
-            || device.deviceProperty(QStringLiteral("ID_INPUT_TOUCHSCREEN")).toInt() == 1) { /* clang-format on */
-            return true;
-        }
-    }
-
-    /* clang-format off */
-    return subsystem == QLatin1String("dvb")
-        || subsystem == QLatin1String("net")
-        || (!device.deviceProperty(QStringLiteral("ID_MEDIA_PLAYER")).toString().isEmpty()
-            && device.parent().deviceProperty(QStringLiteral("ID_MEDIA_PLAYER")).toString().isEmpty()) // media-player-info recognized devices
-        || (device.deviceProperty(QStringLiteral("ID_GPHOTO2")).toInt() == 1
-            && device.parent().deviceProperty(QStringLiteral("ID_GPHOTO2")).toInt() != 1); // GPhoto2 cameras
-    /* clang-format on */
+    return DeviceClassifier::instance().isOfInterest(device);
 }
 
 UDevManager::UDevManager(QObject *parent)
@@ -131,14 +185,10 @@ UDevManager::UDevManager(QObject *parent)
 {
     connect(d->m_client, SIGNAL(deviceAdded(UdevQt::Device)), this, SLOT(slotDeviceAdded(UdevQt::Device)));
     connect(d->m_client, SIGNAL(deviceRemoved(UdevQt::Device)), this, SLOT(slotDeviceRemoved(UdevQt::Device)));
+    connect(d->m_client, SIGNAL(deviceChanged(UdevQt::Device)), this, SLOT(slotDeviceChanged(UdevQt::Device)));
+    connect(d->m_client, SIGNAL(eventsDropped()), this, SLOT(slotEventsDropped()));
 
-    // clang-format off
-    d->m_supportedInterfaces << Solid::DeviceInterface::GenericInterface
-                             << Solid::DeviceInterface::Processor
-                             << Solid::DeviceInterface::Camera
-                             << Solid::DeviceInterface::PortableMediaPlayer
-                             << Solid::DeviceInterface::Block;
-    // clang-format on
+    d->m_supportedInterfaces = staticSupportedInterfaces();
 }
 
 UDevManager::~UDevManager()
@@ -146,11 +196,27 @@ UDevManager::~UDevManager()
     delete d;
 }
 
-QString UDevManager::udiPrefix() const
+QString UDevManager::staticUdiPrefix()
 {
     return QString::fromLatin1(UDEV_UDI_PREFIX);
 }
 
+QSet<Solid::DeviceInterface::Type> UDevManager::staticSupportedInterfaces()
+{
+    return {
+        Solid::DeviceInterface::GenericInterface,
+        Solid::DeviceInterface::Processor,
+        Solid::DeviceInterface::Camera,
+        Solid::DeviceInterface::PortableMediaPlayer,
+        Solid::DeviceInterface::Block,
+    };
+}
+
+QString UDevManager::udiPrefix() const
+{
+    return staticUdiPrefix();
+}
+
 QSet<Solid::DeviceInterface::Type> UDevManager::supportedInterfaces() const
 {
     return d->m_supportedInterfaces;
@@ -158,56 +224,33 @@ QSet<Solid::DeviceInterface::Type> UDevManager::supportedInterfaces() const
 
 QStringList UDevManager::allDevices()
 {
-    QStringList res;
-    const UdevQt::DeviceList deviceList = d->m_client->allDevices();
-    for (const UdevQt::Device &device : deviceList) {
-        if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
-            res << udiPrefix() + device.sysfsPath();
-        }
-    }
-    return res;
+    d->seedDeviceTree();
+    return d->m_deviceOrder;
 }
 
 QStringList UDevManager::devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type)
 {
+    if (parentUdi.isEmpty() && type == DeviceInterface::Unknown) {
+        return allDevices();
+    }
+
+    d->seedDeviceTree();
+
     QStringList result;
 
     if (!parentUdi.isEmpty()) {
-        const UdevQt::DeviceList deviceList = d->m_client->allDevices();
-        for (const UdevQt::Device &dev : deviceList) {
-            UDevDevice device(dev);
-            if (device.queryDeviceInterface(type) && d->isOfInterest(udiPrefix() + dev.sysfsPath(), dev) && device.parentUdi() == parentUdi) {
-                result << udiPrefix() + dev.sysfsPath();
+        const QStringList children = d->m_children.value(parentUdi);
+        for (const QString &udi : children) {
+            if (UDevDevice(d->m_deviceTree.value(udi).device).queryDeviceInterface(type)) {
+                result << udi;
             }
         }
         return result;
     }
 
-    if (type == DeviceInterface::Unknown) {
-        return allDevices();
-    }
-
-    UdevQt::DeviceList deviceList;
-
-    // Already limit the number of devices we query and have to create wrapper items for here
-    if (type == Solid::DeviceInterface::Processor) {
-        deviceList = (d->m_client->devicesBySubsystem(QStringLiteral("processor")) //
-                      + d->m_client->devicesBySubsystem(QStringLiteral("cpu")));
-    } else if (type == Solid::DeviceInterface::Camera) {
-        deviceList = d->m_client->devicesBySubsystemsAndProperties({QStringLiteral("usb")}, //
-                                                                   {{QStringLiteral("ID_GPHOTO2"), QStringLiteral("*")}}); // match any
-    } else if (type == Solid::DeviceInterface::PortableMediaPlayer) {
-        deviceList = d->m_client->devicesBySubsystemsAndProperties({QStringLiteral("usb")}, //
-                                                                   {{QStringLiteral("ID_MEDIA_PLAYER"), QStringLiteral("*")}}); // match any
-    } else {
-        deviceList = d->m_client->allDevices();
-    }
-
-    for (const UdevQt::Device &dev : std::as_const(deviceList)) {
-        UDevDevice device(dev);
-        if (device.queryDeviceInterface(type) //
-            && d->isOfInterest(udiPrefix() + dev.sysfsPath(), dev)) {
-            result << udiPrefix() + dev.sysfsPath();
+    for (const QString &udi : std::as_const(d->m_deviceOrder)) {
+        if (UDevDevice(d->m_deviceTree.value(udi).device).queryDeviceInterface(type)) {
+            result << udi;
         }
     }
 
@@ -225,6 +268,16 @@ QObject *UDevManager::createDevice(const QString &udi_)
         return device;
     }
 
+    const auto it = d->m_deviceTree.constFind(udi_);
+    if (it != d->m_deviceTree.constEnd()) {
+        // The tree serves the topology, its entries are snapshots from the last
+        // uevent. Attributes such as the carrier of a network interface change
+        // without one, so device objects are built from a fresh lookup.
+        UdevQt::Device device = d->m_client->deviceBySysfsPath(it->device.sysfsPath());
+        return new UDevDevice(device.isValid() ? device : it->device);
+    }
+
+    // Not (yet) known to be of interest, e.g. asked for before the tree got seeded
     const QString udi = udi_.right(udi_.size() - udiPrefix().size());
     UdevQt::Device device = d->m_client->deviceBySysfsPath(udi);
 
@@ -237,6 +290,7 @@ QObject *UDevManager::createDevice(const QString &udi_)
 
 void UDevManager::slotDeviceAdded(const UdevQt::Device &device)
 {
+    d->m_notOfInterest.remove(udiPrefix() + device.sysfsPath());
     if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
         Q_EMIT deviceAdded(udiPrefix() + device.sysfsPath());
     }
@@ -244,9 +298,55 @@ void UDevManager::slotDeviceAdded(const UdevQt::Device &device)
 
 void UDevManager::slotDeviceRemoved(const UdevQt::Device &device)
 {
-    if (d->isOfInterest(udiPrefix() + device.sysfsPath(), device)) {
-        Q_EMIT deviceRemoved(udiPrefix() + device.sysfsPath());
-        d->m_devicesOfInterest.removeAll(udiPrefix() + device.sysfsPath());
+    const QString udi = udiPrefix() + device.sysfsPath();
+    d->m_notOfInterest.remove(udi);
+    if (d->m_deviceTree.contains(udi) || d->checkOfInterest(device)) {
+        d->removeDevice(udi);
+        Q_EMIT deviceRemoved(udi);
+    }
+}
+
+void UDevManager::slotDeviceChanged(const UdevQt::Device &device)
+{
+    const QString udi = udiPrefix() + device.sysfsPath();
+    const bool wasOfInterest = d->m_deviceTree.contains(udi);
+    d->m_notOfInterest.remove(udi);
+
+    if (d->checkOfInterest(device)) {
+        // Keep the snapshot current, so created devices see the new properties
+        d->insertDevice(udi, device);
+        if (!wasOfInterest) {
+            Q_EMIT deviceAdded(udi);
+        }
+    } else if (wasOfInterest) {
+        d->removeDevice(udi);
+        Q_EMIT deviceRemoved(udi);
+    }
+}
+
+void UDevManager::slotEventsDropped()
+{
+    if (!d->m_deviceTreeSeeded) {
+        return;
+    }
+
+    // The tree may have missed anything, seed it again and report the difference
+    const QHash<QString, Private::Node> previous = std::exchange(d->m_deviceTree, {});
+    const QStringList previousOrder = std::exchange(d->m_deviceOrder, {});
+    d->m_children.clear();
+    d->m_notOfInterest.clear();
+    d->m_deviceTreeSeeded = false;
+    d->seedDeviceTree();
+
+    for (const QString &udi : previousOrder) {
+        if (!d->m_deviceTree.contains(udi)) {
+            Q_EMIT deviceRemoved(udi);
+        }
+    }
+    for (const QString &udi : std::as_const(d->m_deviceOrder)) {
+        if (!previous.contains(udi)) {
+            Q_EMIT deviceAdded(udi);
+        }
     }
 }
 
@@ -25,6 +25,10 @@ public:
     UDevManager(QObject *parent);
     ~UDevManager() override;
 
+    // What the backend declares before it exists, for it to be created lazily
+    static QString staticUdiPrefix();
+    static QSet<Solid::DeviceInterface::Type> staticSupportedInterfaces();
+
     QString udiPrefix() const override;
     QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
 
@@ -37,6 +41,8 @@ public:
 private Q_SLOTS:
     void slotDeviceAdded(const UdevQt::Device &device);
     void slotDeviceRemoved(const UdevQt::Device &device);
+    void slotDeviceChanged(const UdevQt::Device &device);
+    void slotEventsDropped();
 
 private:
     class Private;
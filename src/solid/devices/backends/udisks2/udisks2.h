@@ -46,6 +46,7 @@ Q_DECLARE_METATYPE(DBUSManagerStruct)
 #define UD2_DBUS_INTERFACE_ENCRYPTED     "org.freedesktop.UDisks2.Encrypted"
 #define UD2_DBUS_INTERFACE_SWAP          "org.freedesktop.UDisks2.Swapspace"
 #define UD2_DBUS_INTERFACE_LOOP          "org.freedesktop.UDisks2.Loop"
+#define UD2_DBUS_INTERFACE_JOB           "org.freedesktop.UDisks2.Job"
 
 /* errors */
 #define UD2_ERROR_UNAUTHORIZED            "org.freedesktop.PolicyKit.Error.NotAuthorized"
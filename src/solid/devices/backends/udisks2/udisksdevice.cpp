@@ -92,8 +92,11 @@ Device::Device(const QString &udi)
     , m_backend(DeviceBackend::backendForUDI(udi))
 {
     if (m_backend) {
-        connect(m_backend, &DeviceBackend::changed, this, &Device::changed);
-        connect(m_backend, &DeviceBackend::propertyChanged, this, &Device::propertyChanged);
+        // queued when this device lives in another thread than the shared backend
+        connect(m_backend.get(), &DeviceBackend::changed, this, &Device::changed);
+        connect(m_backend.get(), &DeviceBackend::propertyChanged, this, &Device::propertyChanged);
+        connect(m_backend.get(), &DeviceBackend::jobChanged, this, &Device::jobChanged);
+        connect(m_backend.get(), &DeviceBackend::jobCompleted, this, &Device::jobCompleted);
     } else {
         qCDebug(UDISKS2) << "Created invalid Device for udi" << udi;
     }
@@ -200,22 +203,33 @@ QObject *Device::createDeviceInterface(const Solid::DeviceInterface::Type &type)
 }
 
 bool Device::queryDeviceInterface(const Solid::DeviceInterface::Type &type) const
+{
+    if (!m_backend) {
+        return type == Solid::DeviceInterface::GenericInterface;
+    }
+
+    return providesInterface(*m_backend, type);
+}
+
+bool Device::providesInterface(const DeviceBackend &backend, Solid::DeviceInterface::Type type)
 {
     switch (type) {
     case Solid::DeviceInterface::GenericInterface:
         return true;
-    case Solid::DeviceInterface::Block:
-        return isBlock() || isDrive();
+    case Solid::DeviceInterface::Block: {
+        const QStringList interfaces = backend.interfaces();
+        return interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_BLOCK)) || interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_DRIVE));
+    }
     case Solid::DeviceInterface::StorageVolume:
-        return isStorageVolume();
+        return isStorageVolume(backend);
     case Solid::DeviceInterface::StorageAccess:
-        return isStorageAccess();
+        return isStorageAccess(backend);
     case Solid::DeviceInterface::StorageDrive:
-        return isDrive();
+        return backend.interfaces().contains(QLatin1String(UD2_DBUS_INTERFACE_DRIVE));
     case Solid::DeviceInterface::OpticalDrive:
-        return isOpticalDrive();
+        return isOpticalDrive(backend);
     case Solid::DeviceInterface::OpticalDisc:
-        return isOpticalDisc();
+        return isOpticalDisc(backend);
     default:
         return false;
     }
@@ -248,6 +262,17 @@ QString Device::description() const
         return hintName;
     }
 
+    if (m_backend) {
+        return m_backend->derivedValue(DeviceBackend::DerivedValue::Description, [this]() {
+            return computeDescription();
+        });
+    }
+
+    return computeDescription();
+}
+
+QString Device::computeDescription() const
+{
     if (isLoop()) {
         return loopDescription();
     } else if (isSwap()) {
@@ -597,7 +622,20 @@ QString Device::icon() const
 
     if (!iconName.isEmpty()) {
         return iconName;
-    } else if (isRoot()) {
+    }
+
+    if (m_backend) {
+        return m_backend->derivedValue(DeviceBackend::DerivedValue::Icon, [this]() {
+            return computeIcon();
+        });
+    }
+
+    return computeIcon();
+}
+
+QString Device::computeIcon() const
+{
+    if (isRoot()) {
         return QStringLiteral("drive-harddisk-root");
     } else if (isLoop()) {
         const QString backingFile = prop(QStringLiteral("BackingFile")).toString();
@@ -800,12 +838,25 @@ bool Device::isPartitionTable() const
 
 bool Device::isStorageVolume() const
 {
-    return isPartition() || isPartitionTable() || isStorageAccess() || isOpticalDisc();
+    return m_backend && isStorageVolume(*m_backend);
+}
+
+bool Device::isStorageVolume(const DeviceBackend &backend)
+{
+    const QStringList interfaces = backend.interfaces();
+    return interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_PARTITION)) || interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_PARTITIONTABLE))
+        || isStorageAccess(backend) || isOpticalDisc(backend);
 }
 
 bool Device::isStorageAccess() const
 {
-    return hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM)) || isEncryptedContainer();
+    return m_backend && isStorageAccess(*m_backend);
+}
+
+bool Device::isStorageAccess(const DeviceBackend &backend)
+{
+    const QStringList interfaces = backend.interfaces();
+    return interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_FILESYSTEM)) || interfaces.contains(QLatin1String(UD2_DBUS_INTERFACE_ENCRYPTED));
 }
 
 bool Device::isDrive() const
@@ -815,18 +866,29 @@ bool Device::isDrive() const
 
 bool Device::isOpticalDrive() const
 {
-    return isDrive() && !prop(QStringLiteral("MediaCompatibility")).toStringList().filter(QStringLiteral("optical_")).isEmpty();
+    return m_backend && isOpticalDrive(*m_backend);
+}
+
+bool Device::isOpticalDrive(const DeviceBackend &backend)
+{
+    return backend.interfaces().contains(QLatin1String(UD2_DBUS_INTERFACE_DRIVE))
+        && !backend.prop(QStringLiteral("MediaCompatibility")).toStringList().filter(QStringLiteral("optical_")).isEmpty();
 }
 
 bool Device::isOpticalDisc() const
 {
-    const QString drv = drivePath();
+    return m_backend && isOpticalDisc(*m_backend);
+}
+
+bool Device::isOpticalDisc(const DeviceBackend &backend)
+{
+    const QString drv = backend.prop(QStringLiteral("Drive")).value<QDBusObjectPath>().path();
     if (drv.isEmpty() || drv == QLatin1String("/")) {
         return false;
     }
 
-    Device drive(drv);
-    return drive.prop(QStringLiteral("Optical")).toBool();
+    const auto driveBackend = DeviceBackend::backendForUDI(drv);
+    return driveBackend && driveBackend->prop(QStringLiteral("Optical")).toBool();
 }
 
 bool Device::mightBeOpticalDisc() const
@@ -836,8 +898,8 @@ bool Device::mightBeOpticalDisc() const
         return false;
     }
 
-    Device drive(drv);
-    return drive.isOpticalDrive();
+    const auto driveBackend = DeviceBackend::backendForUDI(drv);
+    return driveBackend && isOpticalDrive(*driveBackend);
 }
 
 bool Device::isMounted() const
@@ -17,6 +17,8 @@
 #include <QDBusObjectPath>
 #include <QStringList>
 
+#include <memory>
+
 namespace Solid
 {
 namespace Backends
@@ -71,14 +73,26 @@ public:
 
     QString drivePath() const;
 
+    // The interface checks of queryDeviceInterface() answered from a backend
+    // alone, for the manager to test devices without creating a Device
+    static bool providesInterface(const DeviceBackend &backend, Solid::DeviceInterface::Type type);
+    static bool isStorageVolume(const DeviceBackend &backend);
+    static bool isStorageAccess(const DeviceBackend &backend);
+    static bool isOpticalDrive(const DeviceBackend &backend);
+    static bool isOpticalDisc(const DeviceBackend &backend);
+
 Q_SIGNALS:
     void changed();
     void propertyChanged(const QMap<QString, int> &changes);
+    void jobChanged(const QString &jobPath, const QVariantMap &properties);
+    void jobCompleted(const QString &jobPath, bool success, const QString &message);
 
 protected:
-    QPointer<DeviceBackend> m_backend;
+    std::shared_ptr<DeviceBackend> m_backend;
 
 private:
+    QString computeDescription() const;
+    QString computeIcon() const;
     QString loopDescription() const;
     QString storageDescription() const;
     QString volumeDescription() const;
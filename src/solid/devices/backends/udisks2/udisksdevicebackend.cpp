@@ -9,36 +9,89 @@
 #include "udisksdevicebackend.h"
 #include "udisks_debug.h"
 
+#include <QCoreApplication>
+#include <QDBusArgument>
 #include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QMutexLocker>
 #include <QXmlStreamReader>
 
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
 #include "solid/deviceinterface.h"
 #include "solid/genericinterface.h"
 
 using namespace Solid::Backends::UDisks2;
 
-/* Static cache for DeviceBackends for all UDIs */
-QThreadStorage<QMap<QString /* UDI */, DeviceBackend *>> DeviceBackend::s_backends;
+Q_GLOBAL_STATIC(BackendDispatcher, globalBackendDispatcher)
+
+/* Static cache for DeviceBackends for all UDIs, shared by all threads */
+QMutex DeviceBackend::s_backendsLock;
+QHash<QString /* UDI */, std::shared_ptr<DeviceBackend>> DeviceBackend::s_backends;
 
-DeviceBackend *DeviceBackend::backendForUDI(const QString &udi, bool create)
+std::atomic<quint64> DeviceBackend::s_derivedValueHits = 0;
+std::atomic<quint64> DeviceBackend::s_derivedValueMisses = 0;
+
+std::shared_ptr<DeviceBackend> DeviceBackend::backendForUDI(const QString &udi, bool create)
 {
-    DeviceBackend *backend = nullptr;
     if (udi.isEmpty()) {
-        return backend;
+        return nullptr;
+    }
+
+    {
+        QMutexLocker locker(&s_backendsLock);
+        auto backend = s_backends.value(udi);
+        if (backend || !create) {
+            return backend;
+        }
+    }
+
+    // Construct outside of the lock, it involves blocking D-Bus calls
+    return registerBackend(new DeviceBackend(udi));
+}
+
+void DeviceBackend::preloadBackend(const QString &udi, const VariantMapMap &interfacesAndProperties)
+{
+    {
+        QMutexLocker locker(&s_backendsLock);
+        if (s_backends.contains(udi)) {
+            return;
+        }
     }
 
-    backend = s_backends.localData().value(udi);
-    if (!backend && create) {
-        backend = new DeviceBackend(udi);
-        s_backends.localData().insert(udi, backend);
+    registerBackend(new DeviceBackend(udi, interfacesAndProperties));
+}
+
+std::shared_ptr<DeviceBackend> DeviceBackend::registerBackend(DeviceBackend *backend)
+{
+    BackendDispatcher::ensureCreated();
+
+    // The object is handed over to the main thread so that it keeps receiving D-Bus
+    // signals whichever thread created it, and deleted there once nobody uses it anymore.
+    std::shared_ptr<DeviceBackend> shared(backend, [](DeviceBackend *object) {
+        object->deleteLater();
+    });
+    if (QCoreApplication::instance()) {
+        shared->moveToThread(QCoreApplication::instance()->thread());
     }
 
-    return backend;
+    QMutexLocker locker(&s_backendsLock);
+    // another thread may have been quicker, keep the first one
+    auto it = s_backends.constFind(shared->udi());
+    if (it != s_backends.constEnd()) {
+        return it.value();
+    }
+    s_backends.insert(shared->udi(), shared);
+    return shared;
 }
 
 void DeviceBackend::destroyBackend(const QString &udi)
 {
-    delete s_backends.localData().take(udi);
+    // Devices still holding it keep it alive until they go away
+    QMutexLocker locker(&s_backendsLock);
+    s_backends.remove(udi);
 }
 
 DeviceBackend::DeviceBackend(const QString &udi)
@@ -46,28 +99,29 @@ DeviceBackend::DeviceBackend(const QString &udi)
 {
     // qDebug() << "Creating backend for device" << m_udi;
 
-    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE), //
-                                         m_udi,
-                                         QStringLiteral(DBUS_INTERFACE_PROPS),
-                                         QStringLiteral("PropertiesChanged"),
-                                         this,
-                                         SLOT(slotPropertiesChanged(QString, QVariantMap, QStringList)));
-    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
-                                         QStringLiteral(UD2_DBUS_PATH),
-                                         QStringLiteral(DBUS_INTERFACE_MANAGER),
-                                         QStringLiteral("InterfacesAdded"),
-                                         this,
-                                         SLOT(slotInterfacesAdded(QDBusObjectPath, VariantMapMap)));
-    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
-                                         QStringLiteral(UD2_DBUS_PATH),
-                                         QStringLiteral(DBUS_INTERFACE_MANAGER),
-                                         QStringLiteral("InterfacesRemoved"),
-                                         this,
-                                         SLOT(slotInterfacesRemoved(QDBusObjectPath, QStringList)));
-
+    QMutexLocker locker(&m_lock);
     initInterfaces();
 }
 
+DeviceBackend::DeviceBackend(const QString &udi, const VariantMapMap &interfacesAndProperties)
+    : m_udi(udi)
+{
+    QMutexLocker locker(&m_lock);
+    for (auto it = interfacesAndProperties.cbegin(); it != interfacesAndProperties.cend(); ++it) {
+        /* Same filtering as initInterfaces() */
+        if (!it.key().startsWith(QStringLiteral(UD2_DBUS_SERVICE))) {
+            continue;
+        }
+
+        m_interfaces.append(it.key());
+        const QVariantMap &props = it.value();
+        for (auto prop = props.cbegin(); prop != props.cend(); ++prop) {
+            cacheProperty(prop.key(), prop.value());
+        }
+    }
+    m_propertiesLoaded = true;
+}
+
 DeviceBackend::~DeviceBackend()
 {
     // qDebug() << "Destroying backend for device" << m_udi;
@@ -101,6 +155,7 @@ void DeviceBackend::initInterfaces()
 
 QStringList DeviceBackend::interfaces() const
 {
+    QMutexLocker locker(&m_lock);
     return m_interfaces;
 }
 
@@ -111,47 +166,313 @@ const QString &DeviceBackend::udi() const
 
 QVariant DeviceBackend::prop(const QString &key) const
 {
-    checkCache(key);
+    QMutexLocker locker(&m_lock);
+    checkCache(key, locker);
     return m_propertyCache.value(key);
 }
 
 bool DeviceBackend::propertyExists(const QString &key) const
 {
-    checkCache(key);
-    /* checkCache() will put an invalid QVariant in cache when the property
-     * does not exist, so check for validity, not for an actual presence. */
-    return m_propertyCache.value(key).isValid();
+    QMutexLocker locker(&m_lock);
+    checkCache(key, locker);
+    return m_propertyCache.contains(key);
 }
 
 QVariantMap DeviceBackend::allProperties() const
 {
+    QMutexLocker locker(&m_lock);
+    loadAllProperties(locker);
+    return m_propertyCache;
+}
+
+void DeviceBackend::loadAllProperties(QMutexLocker<QMutex> &locker) const
+{
+    startLoadingProperties();
+    const QList<QDBusPendingCall> calls = m_pendingCalls;
+    const quint64 serial = m_loadSerial;
+
+    // The lock is released while waiting, readers of the cached properties and
+    // the D-Bus signals don't wait for the replies
+    locker.unlock();
+    for (QDBusPendingCall call : calls) {
+        call.waitForFinished();
+    }
+    locker.relock();
+
+    // Unless another reader or the prefetch merged them meanwhile, or they got superseded
+    if (serial == m_loadSerial && m_loading) {
+        finishLoadingProperties();
+    }
+}
+
+bool DeviceBackend::startLoadingProperties() const
+{
+    if (m_loading) {
+        return false;
+    }
+
     QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE), //
                                                        m_udi,
                                                        QStringLiteral(DBUS_INTERFACE_PROPS),
                                                        QStringLiteral("GetAll"));
 
+    // Send all the calls before waiting for any reply
     for (const QString &iface : std::as_const(m_interfaces)) {
         call.setArguments(QVariantList() << iface);
-        QDBusPendingReply<QVariantMap> reply = QDBusConnection::systemBus().call(call);
+        m_pendingCalls.append(QDBusConnection::systemBus().asyncCall(call));
+    }
+    m_loading = true;
+    ++m_loadSerial;
+    m_changedWhileLoading.clear();
+    return true;
+}
+
+void DeviceBackend::finishLoadingProperties() const
+{
+    const QList<QDBusPendingCall> calls = std::exchange(m_pendingCalls, {});
+    m_loading = false;
+
+    bool complete = true;
+    QSet<QString> loaded;
+    for (const QDBusPendingCall &call : calls) {
+        QDBusPendingReply<QVariantMap> reply = call;
 
         if (reply.isValid()) {
             auto props = reply.value();
             // Can not use QMap<>::unite(), as it allows multiple values per key
             for (auto it = props.cbegin(); it != props.cend(); ++it) {
-                cacheProperty(it.key(), it.value());
+                loaded.insert(it.key());
+                // the signals received since the calls were sent are more recent
+                if (!m_changedWhileLoading.contains(it.key())) {
+                    cacheProperty(it.key(), it.value());
+                }
             }
         } else {
             qCWarning(UDISKS2) << "Error getting props:" << reply.error().name() << reply.error().message() << "for" << m_udi;
+            complete = false;
         }
-        // qDebug() << "After iface" << iface << ", cache now contains" << m_propertyCache.size() << "items";
     }
 
-    return m_propertyCache;
+    m_propertiesLoaded = complete;
+    if (complete) {
+        // Drop the values kept during the load of properties the interfaces no longer have
+        m_propertyCache.removeIf([&loaded, this](const QVariantMap::iterator &it) {
+            return !loaded.contains(it.key()) && !m_changedWhileLoading.contains(it.key());
+        });
+        m_invalidatedProperties.intersect(m_changedWhileLoading);
+    }
+    m_changedWhileLoading.clear();
+}
+
+void DeviceBackend::prefetchProperties()
+{
+    QMutexLocker locker(&m_lock);
+    prefetchAllProperties();
+}
+
+void DeviceBackend::prefetchAllProperties()
+{
+    if (!startLoadingProperties()) {
+        return; // already in flight
+    }
+
+    const quint64 serial = m_loadSerial;
+    for (const QDBusPendingCall &call : std::as_const(m_pendingCalls)) {
+        auto watcher = new QDBusPendingCallWatcher(call);
+        watcher->moveToThread(thread());
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, serial]() {
+            watcher->deleteLater();
+
+            // The replies get merged once all of them arrived, unless a reader did first
+            QMutexLocker locker(&m_lock);
+            const bool finished = std::all_of(m_pendingCalls.cbegin(), m_pendingCalls.cend(), [](const QDBusPendingCall &pending) {
+                return pending.isFinished();
+            });
+            if (serial == m_loadSerial && m_loading && finished) {
+                finishLoadingProperties();
+            }
+        });
+    }
 }
 
 void DeviceBackend::invalidateProperties()
 {
-    m_propertyCache.clear();
+    QMutexLocker locker(&m_lock);
+    const QString containerUdi = cryptoBackingDevicePath();
+    // The cached values keep serving the readers until the reload replaces them,
+    // replies of a load started before may predate the change and get dropped
+    m_pendingCalls.clear();
+    m_loading = false;
+    m_absentProperties.clear();
+    m_propertiesLoaded = false;
+    prefetchAllProperties();
+    invalidateDerivedValues();
+    const bool isDrive = m_interfaces.contains(QStringLiteral(UD2_DBUS_INTERFACE_DRIVE));
+    locker.unlock();
+
+    if (isDrive) {
+        invalidateDerivedValuesOfDrive(m_udi);
+    }
+    invalidateDerivedValuesOfContainer(containerUdi);
+}
+
+QString DeviceBackend::derivedValue(DerivedValue value, const std::function<QString()> &compute)
+{
+    const auto index = static_cast<size_t>(value);
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_derivedValues[index]) {
+            ++s_derivedValueHits;
+            return *m_derivedValues[index];
+        }
+        generation = m_derivedValuesGeneration;
+    }
+
+    const quint64 misses = ++s_derivedValueMisses;
+    if (misses % 1024 == 0) {
+        const quint64 hits = s_derivedValueHits;
+        qCDebug(UDISKS2) << "Derived values:" << hits << "hits," << misses << "misses," << (100 * hits / (hits + misses)) << "% hit rate";
+    }
+
+    // Computed without the lock, it reads properties of this backend and others
+    const QString result = compute();
+
+    QMutexLocker locker(&m_lock);
+    if (generation == m_derivedValuesGeneration) {
+        m_derivedValues[index] = result;
+    }
+    return result;
+}
+
+DeviceBackend::DerivedValueStatistics DeviceBackend::derivedValueStatistics()
+{
+    return {s_derivedValueHits, s_derivedValueMisses};
+}
+
+bool DeviceBackend::affectsDerivedValues(const QString &key)
+{
+    // The properties read to build the descriptions and icons, of the device
+    // itself or of its drive
+    static const QSet<QString> keys = {
+        QStringLiteral("BackingFile"),
+        QStringLiteral("CleartextDevice"),
+        QStringLiteral("ConnectionBus"),
+        QStringLiteral("CryptoBackingDevice"),
+        QStringLiteral("Device"),
+        QStringLiteral("Drive"),
+        QStringLiteral("IdLabel"),
+        QStringLiteral("IdType"),
+        QStringLiteral("IdUsage"),
+        QStringLiteral("Media"),
+        QStringLiteral("MediaAvailable"),
+        QStringLiteral("MediaCompatibility"),
+        QStringLiteral("MediaRemovable"),
+        QStringLiteral("Model"),
+        QStringLiteral("MountPoints"),
+        QStringLiteral("Name"),
+        QStringLiteral("Optical"),
+        QStringLiteral("OpticalBlank"),
+        QStringLiteral("OpticalNumAudioTracks"),
+        QStringLiteral("OpticalNumDataTracks"),
+        QStringLiteral("PreferredDevice"),
+        QStringLiteral("Removable"),
+        QStringLiteral("Size"),
+        QStringLiteral("TimeMediaDetected"),
+        QStringLiteral("Vendor"),
+    };
+    return keys.contains(key);
+}
+
+void DeviceBackend::invalidateDerivedValues()
+{
+    m_derivedValues.fill(std::nullopt);
+    ++m_derivedValuesGeneration;
+}
+
+QList<std::shared_ptr<DeviceBackend>> DeviceBackend::allBackends()
+{
+    QMutexLocker locker(&s_backendsLock);
+    return s_backends.values();
+}
+
+QString DeviceBackend::drivePath(QMutexLocker<QMutex> &locker) const
+{
+    // Only block devices have a drive, don't load the properties of the others for nothing
+    if (!m_interfaces.contains(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK))) {
+        return QString();
+    }
+
+    checkCache(QStringLiteral("Drive"), locker);
+    return m_propertyCache.value(QStringLiteral("Drive")).value<QDBusObjectPath>().path();
+}
+
+QString DeviceBackend::cachedDrivePath() const
+{
+    return m_propertyCache.value(QStringLiteral("Drive")).value<QDBusObjectPath>().path();
+}
+
+QString DeviceBackend::cryptoBackingDevicePath() const
+{
+    // Cached only: a container whose cleartext device was never looked at has
+    // nothing derived from it
+    const QString path = m_propertyCache.value(QStringLiteral("CryptoBackingDevice")).value<QDBusObjectPath>().path();
+    return path == QLatin1String("/") ? QString() : path;
+}
+
+QStringList DeviceBackend::blockDevicesOfDrive(const QString &driveUdi)
+{
+    const auto backends = allBackends();
+
+    QStringList result;
+    for (const auto &backend : backends) {
+        QMutexLocker locker(&backend->m_lock);
+        if (backend->drivePath(locker) == driveUdi) {
+            result.append(backend->m_udi);
+        }
+    }
+
+    return result;
+}
+
+QList<std::shared_ptr<DeviceBackend>> DeviceBackend::backendsOfJobObjects(const QStringList &objects)
+{
+    const auto backends = allBackends();
+
+    // A job on a drive, e.g. an eject, concerns all of its block devices. Only
+    // the cached drive paths are looked at, nothing gets loaded for a job: the
+    // block devices of interest were preloaded with all of their properties.
+    QList<std::shared_ptr<DeviceBackend>> result;
+    for (const auto &backend : backends) {
+        QMutexLocker locker(&backend->m_lock);
+        if (objects.contains(backend->m_udi) || objects.contains(backend->cachedDrivePath())) {
+            result.append(backend);
+        }
+    }
+
+    return result;
+}
+
+void DeviceBackend::invalidateDerivedValuesOfDrive(const QString &driveUdi)
+{
+    const auto backends = allBackends();
+
+    for (const auto &backend : backends) {
+        QMutexLocker locker(&backend->m_lock);
+        // Derived values are built from the drive path, a backend without it cached has none
+        if (backend->cachedDrivePath() == driveUdi) {
+            backend->invalidateDerivedValues();
+        }
+    }
+}
+
+void DeviceBackend::invalidateDerivedValuesOfContainer(const QString &containerUdi)
+{
+    // The icon of an unlocked container depends on where its cleartext device is mounted
+    if (const auto container = backendForUDI(containerUdi, false)) {
+        QMutexLocker locker(&container->m_lock);
+        container->invalidateDerivedValues();
+    }
 }
 
 QString DeviceBackend::introspect() const
@@ -167,16 +488,36 @@ QString DeviceBackend::introspect() const
     }
 }
 
-void DeviceBackend::checkCache(const QString &key) const
+void DeviceBackend::checkCache(const QString &key, QMutexLocker<QMutex> &locker) const
 {
-    if (m_propertyCache.isEmpty()) { // recreate the cache
-        allProperties();
+    if (m_propertyCache.contains(key) || m_absentProperties.contains(key)) {
+        return;
     }
 
-    if (m_propertyCache.contains(key)) {
+    // Only this one is missing, no need to reload the others
+    if (m_invalidatedProperties.contains(key)) {
+        fetchProperty(key, locker);
         return;
     }
 
+    if (!m_propertiesLoaded) { // recreate the cache, or wait for a refresh in flight
+        loadAllProperties(locker);
+        if (m_propertyCache.contains(key)) {
+            return;
+        }
+    }
+
+    // The interfaces don't have such a property, no need to ask again until they change
+    if (m_propertiesLoaded) {
+        m_absentProperties.insert(key);
+        return;
+    }
+
+    fetchProperty(key, locker);
+}
+
+void DeviceBackend::fetchProperty(const QString &key, QMutexLocker<QMutex> &locker) const
+{
     QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE), m_udi, QStringLiteral(DBUS_INTERFACE_PROPS), QStringLiteral("Get"));
     /*
      * Interface is set to an empty string as in this QDBusInterface is a meta-object of multiple interfaces on the same path
@@ -184,15 +525,25 @@ void DeviceBackend::checkCache(const QString &key) const
      * This matches what QDBusAbstractInterface would do
      */
     call.setArguments(QVariantList() << QString() << key);
+
+    locker.unlock();
     QDBusPendingReply<QVariant> reply = QDBusConnection::systemBus().call(call);
+    locker.relock();
+
+    // A PropertiesChanged signal received meanwhile brought a more recent value
+    if (m_propertyCache.contains(key)) {
+        return;
+    }
 
-    /* We don't check for error here and store the item in the cache anyway so next time we don't have to
-     * do the DBus call to find out it does not exist but just check whether
-     * prop(key).isValid() */
-    cacheProperty(key, reply.value());
+    m_invalidatedProperties.remove(key);
+    if (reply.isValid()) {
+        cacheProperty(key, reply.value());
+    } else {
+        m_absentProperties.insert(key);
+    }
 }
 
-void DeviceBackend::slotPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps)
+void DeviceBackend::propertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps)
 {
     if (!ifaceName.startsWith(QStringLiteral(UD2_DBUS_SERVICE))) {
         return;
@@ -201,8 +552,13 @@ void DeviceBackend::slotPropertiesChanged(const QString &ifaceName, const QVaria
 
     QMap<QString, int> changeMap;
 
+    QMutexLocker locker(&m_lock);
+    const QString previousContainerUdi = cryptoBackingDevicePath();
+    const bool loading = m_loading;
     for (const QString &key : invalidatedProps) {
         m_propertyCache.remove(key);
+        // the cache misses this property now, refetch it alone on the next read
+        m_invalidatedProperties.insert(key);
         changeMap.insert(key, Solid::GenericInterface::PropertyModified);
         // qDebug() << "\t invalidated:" << key;
     }
@@ -212,43 +568,78 @@ void DeviceBackend::slotPropertiesChanged(const QString &ifaceName, const QVaria
         i.next();
         const QString key = i.key();
         cacheProperty(key, i.value()); // replace the value
+        m_invalidatedProperties.remove(key);
+        m_absentProperties.remove(key);
         changeMap.insert(key, Solid::GenericInterface::PropertyModified);
         // qDebug() << "\t modified:" << key << ":" << m_propertyCache.value(key);
     }
 
+    if (loading) {
+        for (auto it = changeMap.keyBegin(); it != changeMap.keyEnd(); ++it) {
+            m_changedWhileLoading.insert(*it);
+        }
+    }
+
+    const bool derivedValuesChanged = std::any_of(changeMap.keyBegin(), changeMap.keyEnd(), &DeviceBackend::affectsDerivedValues);
+    if (derivedValuesChanged) {
+        invalidateDerivedValues();
+    }
+    const bool isDrive = m_interfaces.contains(QStringLiteral(UD2_DBUS_INTERFACE_DRIVE));
+    const QString containerUdi = cryptoBackingDevicePath();
+    locker.unlock();
+
+    if (derivedValuesChanged && isDrive) {
+        invalidateDerivedValuesOfDrive(m_udi);
+    }
+    if (derivedValuesChanged) {
+        invalidateDerivedValuesOfContainer(containerUdi);
+        if (previousContainerUdi != containerUdi) {
+            invalidateDerivedValuesOfContainer(previousContainerUdi);
+        }
+    }
+
     Q_EMIT propertyChanged(changeMap);
     Q_EMIT changed();
 }
 
-void DeviceBackend::slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties)
+void DeviceBackend::interfacesAdded(const VariantMapMap &interfaces_and_properties)
 {
-    if (object_path.path() != m_udi) {
-        return;
-    }
-
+    QMutexLocker locker(&m_lock);
+    invalidateDerivedValues();
     for (auto it = interfaces_and_properties.cbegin(); it != interfaces_and_properties.cend(); ++it) {
         const QString &iface = it.key();
         /* Don't store generic DBus interfaces */
         if (iface.startsWith(QStringLiteral(UD2_DBUS_SERVICE))) {
             m_interfaces.append(iface);
+
+            const QVariantMap &props = it.value();
+            for (auto prop = props.cbegin(); prop != props.cend(); ++prop) {
+                cacheProperty(prop.key(), prop.value());
+                m_absentProperties.remove(prop.key());
+            }
         }
     }
 }
 
-void DeviceBackend::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
+void DeviceBackend::interfacesRemoved(const QStringList &interfaces)
 {
-    if (object_path.path() != m_udi) {
-        return;
-    }
-
+    QMutexLocker locker(&m_lock);
     for (const QString &iface : interfaces) {
         m_interfaces.removeAll(iface);
     }
 
-    // We don't know which property belongs to which interface, so remove all
-    m_propertyCache.clear();
-    if (!m_interfaces.isEmpty()) {
-        allProperties();
+    // We don't know which property belongs to which interface, so reload them all.
+    // The cached values keep serving the readers until then.
+    m_pendingCalls.clear();
+    m_loading = false;
+    m_absentProperties.clear();
+    m_propertiesLoaded = false;
+    invalidateDerivedValues();
+    if (m_interfaces.isEmpty()) {
+        m_propertyCache.clear();
+        m_invalidatedProperties.clear();
+    } else {
+        prefetchAllProperties();
     }
 }
 
@@ -268,4 +659,159 @@ void DeviceBackend::cacheProperty(const QString &key, const QVariant &value) con
     }
 }
 
+void BackendDispatcher::ensureCreated()
+{
+    // Constructed by whichever thread needs a backend first
+    static std::once_flag created;
+    std::call_once(created, []() {
+        BackendDispatcher *dispatcher = globalBackendDispatcher();
+        if (QCoreApplication::instance()) {
+            dispatcher->moveToThread(QCoreApplication::instance()->thread());
+        }
+    });
+}
+
+BackendDispatcher *BackendDispatcher::instance()
+{
+    ensureCreated();
+    return globalBackendDispatcher();
+}
+
+void BackendDispatcher::preloadJob(const QString &jobPath, const VariantMapMap &interfacesAndProperties)
+{
+    BackendDispatcher *dispatcher = instance();
+    QMetaObject::invokeMethod(dispatcher, [dispatcher, jobPath, interfacesAndProperties]() {
+        if (!dispatcher->m_jobs.contains(jobPath)) {
+            dispatcher->slotInterfacesAdded(QDBusObjectPath(jobPath), interfacesAndProperties);
+        }
+    });
+}
+
+BackendDispatcher::BackendDispatcher()
+{
+    // No object path, the match covers every object of the service
+    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
+                                         QString(),
+                                         QStringLiteral(DBUS_INTERFACE_PROPS),
+                                         QStringLiteral("PropertiesChanged"),
+                                         this,
+                                         SLOT(slotPropertiesChanged(QDBusMessage)));
+    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
+                                         QStringLiteral(UD2_DBUS_PATH),
+                                         QStringLiteral(DBUS_INTERFACE_MANAGER),
+                                         QStringLiteral("InterfacesAdded"),
+                                         this,
+                                         SLOT(slotInterfacesAdded(QDBusObjectPath, VariantMapMap)));
+    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
+                                         QStringLiteral(UD2_DBUS_PATH),
+                                         QStringLiteral(DBUS_INTERFACE_MANAGER),
+                                         QStringLiteral("InterfacesRemoved"),
+                                         this,
+                                         SLOT(slotInterfacesRemoved(QDBusObjectPath, QStringList)));
+    QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE),
+                                         QString(),
+                                         QStringLiteral(UD2_DBUS_INTERFACE_JOB),
+                                         QStringLiteral("Completed"),
+                                         this,
+                                         SLOT(slotJobCompleted(QDBusMessage)));
+}
+
+void BackendDispatcher::slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties)
+{
+    const QString path = object_path.path();
+    if (path.startsWith(QLatin1String(UD2_DBUS_PATH_JOBS))) {
+        const QVariantMap properties = interfaces_and_properties.value(QStringLiteral(UD2_DBUS_INTERFACE_JOB));
+        if (!properties.isEmpty()) {
+            QStringList objects;
+            const auto paths = qdbus_cast<QList<QDBusObjectPath>>(properties.value(QStringLiteral("Objects")));
+            for (const QDBusObjectPath &object : paths) {
+                objects.append(object.path());
+            }
+
+            QList<std::weak_ptr<DeviceBackend>> backends;
+            const auto backendsOfObjects = DeviceBackend::backendsOfJobObjects(objects);
+            for (const auto &backend : backendsOfObjects) {
+                backends.append(backend);
+            }
+
+            m_jobs.insert(path, Job{properties, backends});
+            jobChanged(path);
+        }
+        return;
+    }
+
+    if (const auto backend = DeviceBackend::backendForUDI(path, false)) {
+        backend->interfacesAdded(interfaces_and_properties);
+    }
+
+    Q_EMIT interfacesAdded(path, interfaces_and_properties);
+}
+
+void BackendDispatcher::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
+{
+    const QString path = object_path.path();
+    if (m_jobs.remove(path) || path.startsWith(QLatin1String(UD2_DBUS_PATH_JOBS))) {
+        return;
+    }
+
+    if (const auto backend = DeviceBackend::backendForUDI(path, false)) {
+        backend->interfacesRemoved(interfaces);
+    }
+
+    Q_EMIT interfacesRemoved(path, interfaces);
+}
+
+void BackendDispatcher::slotPropertiesChanged(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 3) {
+        return;
+    }
+
+    const auto job = m_jobs.find(message.path());
+    if (job != m_jobs.end()) {
+        if (arguments.at(0).toString() == QLatin1String(UD2_DBUS_INTERFACE_JOB)) {
+            job->properties.insert(qdbus_cast<QVariantMap>(arguments.at(1)));
+            jobChanged(message.path());
+        }
+        return;
+    }
+
+    const QString ifaceName = arguments.at(0).toString();
+    const QVariantMap changedProps = qdbus_cast<QVariantMap>(arguments.at(1));
+    const QStringList invalidatedProps = arguments.at(2).toStringList();
+    if (const auto backend = DeviceBackend::backendForUDI(message.path(), false)) {
+        backend->propertiesChanged(ifaceName, changedProps, invalidatedProps);
+    }
+
+    Q_EMIT propertiesChanged(message.path(), ifaceName, changedProps, invalidatedProps);
+}
+
+void BackendDispatcher::slotJobCompleted(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    const Job job = m_jobs.take(message.path());
+    if (arguments.size() != 2) {
+        return;
+    }
+
+    const bool success = arguments.at(0).toBool();
+    const QString errorMessage = arguments.at(1).toString();
+    for (const auto &weakBackend : job.backends) {
+        if (const auto backend = weakBackend.lock()) {
+            Q_EMIT backend->jobCompleted(message.path(), success, errorMessage);
+        }
+    }
+}
+
+void BackendDispatcher::jobChanged(const QString &jobPath)
+{
+    const Job &job = m_jobs[jobPath];
+    for (const auto &weakBackend : job.backends) {
+        if (const auto backend = weakBackend.lock()) {
+            Q_EMIT backend->jobChanged(jobPath, job.properties);
+        }
+    }
+}
+
 #include "moc_udisksdevicebackend.cpp"
@@ -9,28 +9,60 @@
 #ifndef UDISKSDEVICEBACKEND_H
 #define UDISKSDEVICEBACKEND_H
 
+#include <QDBusMessage>
 #include <QDBusObjectPath>
+#include <QDBusPendingCall>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
-#include <QThreadStorage>
 
 #include "udisks2.h"
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+
 namespace Solid
 {
 namespace Backends
 {
 namespace UDisks2
 {
+/**
+ * Property cache and change tracking of one UDisks2 object.
+ *
+ * Backends are shared by all threads of the process: they live in the main
+ * thread, where the D-Bus signals are handled, and their accessors are
+ * thread-safe. Signals reach Devices living in other threads through queued
+ * connections.
+ */
 class DeviceBackend : public QObject
 {
     Q_OBJECT
 
 public:
-    static DeviceBackend *backendForUDI(const QString &udi, bool create = true);
+    static std::shared_ptr<DeviceBackend> backendForUDI(const QString &udi, bool create = true);
     static void destroyBackend(const QString &udi);
 
+    /**
+     * Creates the backend of @p udi from the interfaces and properties found in
+     * a GetManagedObjects() reply, sparing the D-Bus calls loading them.
+     * Nothing happens if the backend exists already.
+     */
+    static void preloadBackend(const QString &udi, const VariantMapMap &interfacesAndProperties);
+
+    /**
+     * Returns the block devices of the drive @p driveUdi among the known
+     * backends, loading the Drive property of those which didn't have it yet.
+     */
+    static QStringList blockDevicesOfDrive(const QString &driveUdi);
+
     DeviceBackend(const QString &udi);
+    DeviceBackend(const QString &udi, const VariantMapMap &interfacesAndProperties);
     ~DeviceBackend() override;
 
     QVariant prop(const QString &key) const;
@@ -40,28 +72,179 @@ public:
     QStringList interfaces() const;
     const QString &udi() const;
 
+    /**
+     * Reloads all the properties in the background, dropping the replies of a
+     * load in flight. The cached values keep serving the reads until the new
+     * ones are merged.
+     */
     void invalidateProperties();
+
+    /**
+     * Reloads the properties in the background. Until the replies arrive,
+     * reads are served from the properties cached so far, or wait for the
+     * replies if there are none.
+     */
+    void prefetchProperties();
+
+    /**
+     * Strings derived from the properties of the device and of its drive,
+     * which are expensive to build.
+     */
+    enum class DerivedValue {
+        Description,
+        Icon,
+    };
+
+    /**
+     * Returns the memoized @p value, built with @p compute if it isn't known.
+     * Memoized values are dropped when the interfaces change or when one
+     * of the properties they depend on changes, on the device, its drive or,
+     * for an encrypted container, its cleartext device.
+     */
+    QString derivedValue(DerivedValue value, const std::function<QString()> &compute);
+
+    struct DerivedValueStatistics {
+        quint64 hits;
+        quint64 misses;
+    };
+
+    /**
+     * Returns how many derived value lookups were served from memory, and
+     * how many had to be computed, across all backends.
+     */
+    static DerivedValueStatistics derivedValueStatistics();
+
 Q_SIGNALS:
     void propertyChanged(const QMap<QString, int> &changeMap);
     void changed();
 
-private Q_SLOTS:
-    void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
-    void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
-    void slotPropertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
+    /**
+     * The UDisks2 job @p jobPath operating on this device started or made
+     * progress, @p properties are all of its org.freedesktop.UDisks2.Job properties.
+     */
+    void jobChanged(const QString &jobPath, const QVariantMap &properties);
+    void jobCompleted(const QString &jobPath, bool success, const QString &message);
 
 private:
+    friend class BackendDispatcher;
+
+    static std::shared_ptr<DeviceBackend> registerBackend(DeviceBackend *backend);
+    static bool affectsDerivedValues(const QString &key);
+    static void invalidateDerivedValuesOfDrive(const QString &driveUdi);
+    static void invalidateDerivedValuesOfContainer(const QString &containerUdi);
+    static QList<std::shared_ptr<DeviceBackend>> backendsOfJobObjects(const QStringList &objects);
+    static QList<std::shared_ptr<DeviceBackend>> allBackends();
+
+    // called by BackendDispatcher, in the main thread
+    void interfacesAdded(const VariantMapMap &interfaces_and_properties);
+    void interfacesRemoved(const QStringList &interfaces);
+    void propertiesChanged(const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
+
+    // the following expect m_lock to be held by the caller, those given the
+    // locker release it while waiting for D-Bus replies
     void initInterfaces();
     QString introspect() const;
-    void checkCache(const QString &key) const;
+    void loadAllProperties(QMutexLocker<QMutex> &locker) const;
+    bool startLoadingProperties() const;
+    void finishLoadingProperties() const;
+    void prefetchAllProperties();
+    void checkCache(const QString &key, QMutexLocker<QMutex> &locker) const;
+    void fetchProperty(const QString &key, QMutexLocker<QMutex> &locker) const;
     void cacheProperty(const QString &key, const QVariant &value) const;
+    void invalidateDerivedValues();
+    QString drivePath(QMutexLocker<QMutex> &locker) const;
+    QString cachedDrivePath() const;
+    QString cryptoBackingDevicePath() const;
 
+    // guards all of the members below
+    mutable QMutex m_lock;
     // NOTE: make sure to insert items only through cacheProperty
     mutable QVariantMap m_propertyCache;
+    // properties the interfaces in m_interfaces don't have
+    mutable QSet<QString> m_absentProperties;
+    // whether m_propertyCache holds every property of m_interfaces, but
+    // those in m_invalidatedProperties
+    mutable bool m_propertiesLoaded = false;
+    // properties UDisks2 invalidated without sending their new value
+    mutable QSet<QString> m_invalidatedProperties;
+    // GetAll calls in flight, one per interface
+    mutable QList<QDBusPendingCall> m_pendingCalls;
+    // whether the replies of m_pendingCalls are still to be merged
+    mutable bool m_loading = false;
+    // bumped when GetAll calls are sent, replies of superseded calls are dropped
+    mutable quint64 m_loadSerial = 0;
+    // properties PropertiesChanged told about while m_pendingCalls were in flight,
+    // the replies may predate them
+    mutable QSet<QString> m_changedWhileLoading;
     QStringList m_interfaces;
-    QString m_udi;
+    // memoized derived values, indexed by DerivedValue
+    std::array<std::optional<QString>, 2> m_derivedValues;
+    // bumped on invalidation, so that values computed meanwhile aren't stored
+    quint64 m_derivedValuesGeneration = 0;
+    const QString m_udi;
+
+    static QMutex s_backendsLock;
+    static QHash<QString, std::shared_ptr<DeviceBackend>> s_backends;
+
+    static std::atomic<quint64> s_derivedValueHits;
+    static std::atomic<quint64> s_derivedValueMisses;
+};
 
-    static QThreadStorage<QMap<QString, DeviceBackend *>> s_backends;
+/**
+ * Receives the signals of all UDisks2 objects through a single subscription
+ * per signal and routes each of them to the DeviceBackend of its object,
+ * found with a lookup in the backend registry.
+ *
+ * It also tracks the UDisks2 jobs, which have no backend of their own, and
+ * reports their progress to the backends of the objects they operate on.
+ *
+ * There is one dispatcher per process, living in the main thread like the
+ * backends it serves. The managers hear about the signals through it as
+ * well, instead of subscribing to them again.
+ */
+class BackendDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void ensureCreated();
+    static BackendDispatcher *instance();
+
+    /**
+     * Starts tracking the job @p jobPath found in a GetManagedObjects() reply,
+     * which was running before any InterfacesAdded() signal could announce it.
+     * Nothing happens if the job is known already.
+     */
+    static void preloadJob(const QString &jobPath, const VariantMapMap &interfacesAndProperties);
+
+    BackendDispatcher();
+
+Q_SIGNALS:
+    /**
+     * Emitted for the signals of every UDisks2 object but the jobs, once
+     * the backend of the object, if there is one, took them into account.
+     */
+    void interfacesAdded(const QString &udi, const VariantMapMap &interfacesAndProperties);
+    void interfacesRemoved(const QString &udi, const QStringList &interfaces);
+    void propertiesChanged(const QString &udi, const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
+
+private Q_SLOTS:
+    void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
+    void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
+    void slotPropertiesChanged(const QDBusMessage &message);
+    void slotJobCompleted(const QDBusMessage &message);
+
+private:
+    void jobChanged(const QString &jobPath);
+
+    struct Job {
+        QVariantMap properties;
+        // backends of the block devices and drives the job operates on, and of the
+        // block devices of those drives, resolved once when the job appeared
+        QList<std::weak_ptr<DeviceBackend>> backends;
+    };
+    // running jobs, by object path
+    QHash<QString, Job> m_jobs;
 };
 
 } /* namespace UDisks2 */
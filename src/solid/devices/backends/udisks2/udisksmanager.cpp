@@ -8,11 +8,15 @@
 #include "udisks_debug.h"
 #include "udisksdevicebackend.h"
 
+#include "exclusionpolicy_p.h"
+
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
 #include <QDBusMetaType>
 #include <QDBusObjectPath>
+#include <QDBusReply>
 #include <QDomDocument>
+#include <QFile>
 
 #include "../shared/rootdevice.h"
 
@@ -23,15 +27,7 @@ Manager::Manager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent)
     , m_manager(QStringLiteral(UD2_DBUS_SERVICE), QStringLiteral(UD2_DBUS_PATH), QDBusConnection::systemBus())
 {
-    m_supportedInterfaces = {
-        Solid::DeviceInterface::GenericInterface,
-        Solid::DeviceInterface::Block,
-        Solid::DeviceInterface::StorageAccess,
-        Solid::DeviceInterface::StorageDrive,
-        Solid::DeviceInterface::OpticalDrive,
-        Solid::DeviceInterface::OpticalDisc,
-        Solid::DeviceInterface::StorageVolume,
-    };
+    m_supportedInterfaces = staticSupportedInterfaces();
 
     qDBusRegisterMetaType<QList<QDBusObjectPath>>();
     qDBusRegisterMetaType<QVariantMap>();
@@ -54,17 +50,21 @@ Manager::Manager(QObject *parent)
     }
 
     if (serviceFound) {
-        connect(&m_manager, SIGNAL(InterfacesAdded(QDBusObjectPath, VariantMapMap)), this, SLOT(slotInterfacesAdded(QDBusObjectPath, VariantMapMap)));
-        connect(&m_manager, SIGNAL(InterfacesRemoved(QDBusObjectPath, QStringList)), this, SLOT(slotInterfacesRemoved(QDBusObjectPath, QStringList)));
+        // The signals of the objects reach the managers of all threads through the
+        // dispatcher, once the device backends took them into account
+        BackendDispatcher *dispatcher = BackendDispatcher::instance();
+        connect(dispatcher, &BackendDispatcher::interfacesAdded, this, &Manager::slotInterfacesAdded);
+        connect(dispatcher, &BackendDispatcher::interfacesRemoved, this, &Manager::slotInterfacesRemoved);
+        connect(dispatcher, &BackendDispatcher::propertiesChanged, this, &Manager::slotPropertiesChanged);
+
+        connect(Solid::ExclusionPolicyPrivate::instance(), &Solid::ExclusionPolicyPrivate::changed, this, &Manager::slotExclusionPolicyChanged);
     }
 }
 
 Manager::~Manager()
 {
-    while (!m_deviceCache.isEmpty()) {
-        QString udi = m_deviceCache.takeFirst();
-        DeviceBackend::destroyBackend(udi);
-    }
+    // The device backends are shared by all threads and outlive this manager,
+    // they get dropped as their devices disappear
 }
 
 QObject *Manager::createDevice(const QString &udi)
@@ -100,8 +100,8 @@ QStringList Manager::devicesFromQuery(const QString &parentUdi, Solid::DeviceInt
         return result;
     } else if (type != Solid::DeviceInterface::Unknown) {
         for (const QString &udi : deviceList) {
-            Device device(udi);
-            if (device.queryDeviceInterface(type)) {
+            const auto backend = DeviceBackend::backendForUDI(udi);
+            if (backend && Device::providesInterface(*backend, type)) {
                 result << udi;
             }
         }
@@ -112,16 +112,107 @@ QStringList Manager::devicesFromQuery(const QString &parentUdi, Solid::DeviceInt
     return deviceCache();
 }
 
+Solid::Ifaces::DeviceManager::MatchResult Manager::matchNatively(const QString &udi, const Solid::Predicate &check)
+{
+    deviceCache(); // enumerate if needed
+    if (udi == udiPrefix() || !m_knownDevices.contains(udi)) {
+        return MatchResult::Unknown;
+    }
+
+    const auto backend = DeviceBackend::backendForUDI(udi);
+    if (!backend) {
+        return MatchResult::Unknown;
+    }
+
+    if (!Device::providesInterface(*backend, check.interfaceType())) {
+        return MatchResult::NoMatch;
+    }
+
+    if (check.type() == Solid::Predicate::InterfaceCheck) {
+        return MatchResult::Match;
+    }
+
+    // Plain string equality on volume identifiers can be answered from the
+    // block device properties without instantiating the frontend interface
+    if (check.interfaceType() == Solid::DeviceInterface::StorageVolume && check.comparisonOperator() == Solid::Predicate::Equals
+        && check.matchingValue().typeId() == QMetaType::QString) {
+        QString key;
+        if (check.propertyName() == QLatin1String("fsType")) {
+            key = QStringLiteral("IdType");
+        } else if (check.propertyName() == QLatin1String("uuid")) {
+            key = QStringLiteral("IdUUID");
+        }
+
+        if (!key.isEmpty()) {
+            return backend->prop(key).toString() == check.matchingValue().toString() ? MatchResult::Match : MatchResult::NoMatch;
+        }
+    }
+
+    return MatchResult::Unknown;
+}
+
 QStringList Manager::allDevices()
 {
     m_deviceCache.clear();
+    m_knownDevices.clear();
 
-    introspect(QStringLiteral(UD2_DBUS_PATH_BLOCKDEVICES), true /*checkOptical*/);
-    introspect(QStringLiteral(UD2_DBUS_PATH_DRIVES));
+    if (!enumerateManagedObjects()) {
+        introspect(QStringLiteral(UD2_DBUS_PATH_BLOCKDEVICES), true /*checkOptical*/);
+        introspect(QStringLiteral(UD2_DBUS_PATH_DRIVES));
+    }
 
     return m_deviceCache;
 }
 
+bool Manager::enumerateManagedObjects()
+{
+    QDBusPendingReply<DBUSManagerStruct> reply = m_manager.GetManagedObjects();
+    reply.waitForFinished();
+    if (reply.isError()) {
+        qCDebug(UDISKS2) << "Failed retrieving the UDisks2 objects, falling back to introspection:" << reply.error().name() << reply.error().message();
+        return false;
+    }
+
+    const QString blockDevicesPath = QStringLiteral(UD2_DBUS_PATH_BLOCKDEVICES "/");
+    const QString drivesPath = QStringLiteral(UD2_DBUS_PATH_DRIVES "/");
+    const QString jobsPath = QStringLiteral(UD2_DBUS_PATH_JOBS);
+
+    // The reply carries the properties of every object, hand them over to the
+    // device backends so that they don't have to fetch them again one by one
+    QStringList blockDevices;
+    QStringList drives;
+    const auto objects = reply.value();
+    for (auto it = objects.cbegin(); it != objects.cend(); ++it) {
+        const QString udi = it.key().path();
+        if (udi.startsWith(blockDevicesPath) && udi.indexOf(QLatin1Char('/'), blockDevicesPath.size()) == -1) {
+            if (isExcluded(udi, it.value())) {
+                continue;
+            }
+            blockDevices.append(udi);
+        } else if (udi.startsWith(drivesPath) && udi.indexOf(QLatin1Char('/'), drivesPath.size()) == -1) {
+            drives.append(udi);
+        } else if (udi.startsWith(jobsPath)) {
+            // Jobs running already, e.g. an eject started by another process
+            BackendDispatcher::preloadJob(udi, it.value());
+            continue;
+        } else {
+            continue;
+        }
+
+        DeviceBackend::preloadBackend(udi, it.value());
+    }
+
+    // Same order as the introspection
+    for (const QString &udi : std::as_const(blockDevices)) {
+        addToDeviceCache(udi, true /*checkOptical*/);
+    }
+    for (const QString &udi : std::as_const(drives)) {
+        addToDeviceCache(udi, false);
+    }
+
+    return true;
+}
+
 void Manager::introspect(const QString &path, bool checkOptical)
 {
     QDBusMessage call =
@@ -137,24 +228,11 @@ void Manager::introspect(const QString &path, bool checkOptical)
             if (!nodeElem.isNull() && nodeElem.hasAttribute(QStringLiteral("name"))) {
                 const QString name = nodeElem.attribute(QStringLiteral("name"));
                 const QString udi = path + QStringLiteral("/") + name;
-
-                // Optimization, a loop device cannot really have a physical drive associated with it
-                if (checkOptical && !name.startsWith(QLatin1String("loop"))) {
-                    Device device(udi);
-                    if (device.mightBeOpticalDisc()) {
-                        QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE), //
-                                                             udi,
-                                                             QStringLiteral(DBUS_INTERFACE_PROPS),
-                                                             QStringLiteral("PropertiesChanged"),
-                                                             this,
-                                                             SLOT(slotMediaChanged(QDBusMessage)));
-                        if (!device.isOpticalDisc()) { // skip empty CD disc
-                            continue;
-                        }
-                    }
+                if (path == QLatin1String(UD2_DBUS_PATH_BLOCKDEVICES) && isExcluded(udi, VariantMapMap())) {
+                    continue;
                 }
 
-                m_deviceCache.append(udi);
+                addToDeviceCache(udi, checkOptical);
             }
         }
     } else {
@@ -162,27 +240,128 @@ void Manager::introspect(const QString &path, bool checkOptical)
     }
 }
 
+bool Manager::isExcluded(const QString &udi, const VariantMapMap &interfacesAndProperties) const
+{
+    const auto policy = Solid::ExclusionPolicyPrivate::instance();
+    if (!policy->isActive()) {
+        return false;
+    }
+
+    // Without the properties at hand, only ask for the few ones needed, no backend
+    // must be created for a device which may be excluded
+    auto property = [&](const QString &iface, const QString &key) -> QVariant {
+        if (interfacesAndProperties.contains(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK))) {
+            return interfacesAndProperties.value(iface).value(key);
+        }
+
+        QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE), udi, QStringLiteral(DBUS_INTERFACE_PROPS), QStringLiteral("Get"));
+        call.setArguments(QVariantList() << iface << key);
+        QDBusReply<QDBusVariant> reply = QDBusConnection::systemBus().call(call);
+        return reply.isValid() ? reply.value().variant() : QVariant();
+    };
+
+    // UDisks2 sends null terminated strings
+    auto toString = [](const QVariant &value) {
+        QByteArray bytes = value.toByteArray();
+        while (bytes.endsWith('\0')) {
+            bytes.chop(1);
+        }
+        return QFile::decodeName(bytes);
+    };
+
+    QString deviceName = toString(property(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK), QStringLiteral("Device"))).section(QLatin1Char('/'), -1);
+    if (deviceName.isEmpty()) {
+        deviceName = udi.section(QLatin1Char('/'), -1);
+    }
+
+    const QVariant backingFile = property(QStringLiteral(UD2_DBUS_INTERFACE_LOOP), QStringLiteral("BackingFile"));
+    const bool isLoop = interfacesAndProperties.contains(QStringLiteral(UD2_DBUS_INTERFACE_LOOP)) || backingFile.isValid();
+
+    return policy->isExcluded(deviceName, isLoop, toString(backingFile));
+}
+
+void Manager::addToDeviceCache(const QString &udi, bool checkOptical)
+{
+    const QString name = udi.section(QLatin1Char('/'), -1);
+
+    // Optimization, a loop device cannot really have a physical drive associated with it
+    if (checkOptical && !name.startsWith(QLatin1String("loop"))) {
+        Device device(udi);
+        if (device.mightBeOpticalDisc()) {
+            m_opticalDevices.insert(udi);
+            if (!device.isOpticalDisc()) { // skip empty CD disc
+                return;
+            }
+        }
+    }
+
+    m_deviceCache.append(udi);
+    m_knownDevices.insert(udi);
+}
+
 QSet<Solid::DeviceInterface::Type> Manager::supportedInterfaces() const
 {
     return m_supportedInterfaces;
 }
 
-QString Manager::udiPrefix() const
+QString Manager::staticUdiPrefix()
 {
     return QStringLiteral(UD2_UDI_DISKS_PREFIX);
 }
 
-void Manager::slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties)
+QSet<Solid::DeviceInterface::Type> Manager::staticSupportedInterfaces()
+{
+    return {
+        Solid::DeviceInterface::GenericInterface,
+        Solid::DeviceInterface::Block,
+        Solid::DeviceInterface::StorageAccess,
+        Solid::DeviceInterface::StorageDrive,
+        Solid::DeviceInterface::OpticalDrive,
+        Solid::DeviceInterface::OpticalDisc,
+        Solid::DeviceInterface::StorageVolume,
+    };
+}
+
+QString Manager::udiPrefix() const
+{
+    return staticUdiPrefix();
+}
+
+bool Manager::notifiesMountPointChanges() const
 {
-    const QString udi = object_path.path();
+    return true;
+}
 
-    /* Ignore jobs */
-    if (udi.startsWith(QStringLiteral(UD2_DBUS_PATH_JOBS))) {
-        return;
+QHash<quint64, QString> Manager::deviceNumbers()
+{
+    QHash<quint64, QString> result;
+
+    const QStringList deviceList = deviceCache();
+    for (const QString &udi : deviceList) {
+        Device device(udi);
+        if (!device.hasInterface(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM)) || !device.isMounted()) {
+            continue;
+        }
+
+        // Files on a block device filesystem report the device's own number as st_dev
+        const quint64 deviceNumber = device.prop(QStringLiteral("DeviceNumber")).toULongLong();
+        if (deviceNumber != 0 && !result.contains(deviceNumber)) {
+            result.insert(deviceNumber, udi);
+        }
     }
 
+    return result;
+}
+
+void Manager::slotInterfacesAdded(const QString &udi, const VariantMapMap &interfaces_and_properties)
+{
     qCDebug(UDISKS2) << udi << "has new interfaces:" << interfaces_and_properties.keys();
 
+    if (!m_knownDevices.contains(udi) && udi.startsWith(QStringLiteral(UD2_DBUS_PATH_BLOCKDEVICES "/")) && isExcluded(udi, interfaces_and_properties)) {
+        qCDebug(UDISKS2) << udi << "is excluded";
+        return;
+    }
+
     // If device gained an org.freedesktop.UDisks2.Block interface, we
     // should check if it is an optical drive, in order to properly
     // register mediaChanged event handler with newly-plugged external
@@ -190,46 +369,41 @@ void Manager::slotInterfacesAdded(const QDBusObjectPath &object_path, const Vari
     if (interfaces_and_properties.contains(QStringLiteral("org.freedesktop.UDisks2.Block"))) {
         Device device(udi);
         if (device.mightBeOpticalDisc()) {
-            QDBusConnection::systemBus().connect(QStringLiteral(UD2_DBUS_SERVICE), //
-                                                 udi,
-                                                 QStringLiteral(DBUS_INTERFACE_PROPS),
-                                                 QStringLiteral("PropertiesChanged"),
-                                                 this,
-                                                 SLOT(slotMediaChanged(QDBusMessage)));
+            m_opticalDevices.insert(udi);
         }
     }
 
     updateBackend(udi);
 
     // new device, we don't know it yet
-    if (!m_deviceCache.contains(udi)) {
+    if (!m_knownDevices.contains(udi)) {
         m_deviceCache.append(udi);
+        m_knownDevices.insert(udi);
         Q_EMIT deviceAdded(udi);
     }
     // re-emit in case of 2-stage devices like N9 or some Android phones
-    else if (m_deviceCache.contains(udi) && interfaces_and_properties.keys().contains(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM))) {
+    else if (interfaces_and_properties.keys().contains(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM))) {
         Q_EMIT deviceAdded(udi);
     }
 }
 
-void Manager::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
+void Manager::slotInterfacesRemoved(const QString &udi, const QStringList &interfaces)
 {
-    const QString udi = object_path.path();
     if (udi.isEmpty()) {
         return;
     }
 
-    /* Ignore jobs */
-    if (udi.startsWith(QStringLiteral(UD2_DBUS_PATH_JOBS))) {
+    qCDebug(UDISKS2) << udi << "lost interfaces:" << interfaces;
+
+    // Don't create a backend for a device we never knew of, e.g. an excluded one
+    if (!m_knownDevices.contains(udi) && !DeviceBackend::backendForUDI(udi, false)) {
         return;
     }
 
-    qCDebug(UDISKS2) << udi << "lost interfaces:" << interfaces;
-
     /*
-     * Determine left interfaces. The device backend may have processed the
+     * Determine left interfaces. The device backend processed the
      * InterfacesRemoved signal already, but the result set is the same
-     * independent if the backend or the manager processes the signal first.
+     * either way.
      */
     Device device(udi);
     const QStringList ifaceList = device.interfaces();
@@ -240,46 +414,79 @@ void Manager::slotInterfacesRemoved(const QDBusObjectPath &object_path, const QS
         // remove the device if the last interface is removed
         Q_EMIT deviceRemoved(udi);
         m_deviceCache.removeAll(udi);
+        m_knownDevices.remove(udi);
+        m_opticalDevices.remove(udi);
         DeviceBackend::destroyBackend(udi);
     } else {
-        /*
-         * Changes in the interface composition may change if a device
-         * matches a Predicate. We have to do a remove-and-readd cycle
-         * as there is no dedicated signal for Predicate reevaluation.
-         */
-        Q_EMIT deviceRemoved(udi);
-        Q_EMIT deviceAdded(udi);
+        // Changes in the interface composition may change if a device matches a Predicate
+        Q_EMIT deviceChanged(udi);
     }
 }
 
-void Manager::slotMediaChanged(const QDBusMessage &msg)
+void Manager::slotPropertiesChanged(const QString &udi, const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps)
 {
-    const QVariantMap properties = qdbus_cast<QVariantMap>(msg.arguments().at(1));
+    if (ifaceName == QLatin1String(UD2_DBUS_INTERFACE_FILESYSTEM)
+        && (changedProps.contains(QStringLiteral("MountPoints")) || invalidatedProps.contains(QStringLiteral("MountPoints")))) {
+        Q_EMIT mountPointsChanged();
+    }
 
+    if (m_opticalDevices.contains(udi)) {
+        mediaChanged(udi, changedProps);
+    }
+}
+
+void Manager::mediaChanged(const QString &udi, const QVariantMap &properties)
+{
     if (!properties.contains(QStringLiteral("Size"))) { // react only on Size changes
         return;
     }
 
-    const QString udi = msg.path();
     updateBackend(udi);
     qulonglong size = properties.value(QStringLiteral("Size")).toULongLong();
     qCDebug(UDISKS2) << "MEDIA CHANGED in" << udi << "; size is:" << size;
 
     Device device(udi);
     if (!device.interfaces().contains(u"org.freedesktop.UDisks2.Filesystem")) {
-        if (!m_deviceCache.contains(udi) && size > 0) { // we don't know the optdisc, got inserted
+        if (!m_knownDevices.contains(udi) && size > 0) { // we don't know the optdisc, got inserted
             m_deviceCache.append(udi);
+            m_knownDevices.insert(udi);
             Q_EMIT deviceAdded(udi);
         }
 
-        if (m_deviceCache.contains(udi) && size == 0) { // we know the optdisc, got removed
+        if (m_knownDevices.contains(udi) && size == 0) { // we know the optdisc, got removed
             Q_EMIT deviceRemoved(udi);
             m_deviceCache.removeAll(udi);
+            m_knownDevices.remove(udi);
             DeviceBackend::destroyBackend(udi);
         }
     }
 }
 
+void Manager::slotExclusionPolicyChanged()
+{
+    if (m_deviceCache.isEmpty()) {
+        return; // nothing enumerated yet
+    }
+
+    const QStringList before = m_deviceCache;
+    const QSet<QString> knownBefore = m_knownDevices;
+    allDevices();
+
+    for (const QString &udi : before) {
+        if (!m_knownDevices.contains(udi)) {
+            Q_EMIT deviceRemoved(udi);
+            m_opticalDevices.remove(udi);
+            DeviceBackend::destroyBackend(udi);
+        }
+    }
+
+    for (const QString &udi : std::as_const(m_deviceCache)) {
+        if (!knownBefore.contains(udi)) {
+            Q_EMIT deviceAdded(udi);
+        }
+    }
+}
+
 const QStringList &Manager::deviceCache()
 {
     if (m_deviceCache.isEmpty()) {
@@ -291,21 +498,23 @@ const QStringList &Manager::deviceCache()
 
 void Manager::updateBackend(const QString &udi)
 {
-    DeviceBackend *backend = DeviceBackend::backendForUDI(udi);
+    const auto backend = DeviceBackend::backendForUDI(udi);
     if (!backend) {
         return;
     }
 
     // This doesn't emit "changed" signals. Signals are emitted later by DeviceBackend's slots
-    backend->allProperties();
+    backend->prefetchProperties();
 
+    // Served from the cached value, or from the replies of the prefetch if the
+    // property wasn't loaded yet, this doesn't issue a call of its own
     QVariant driveProp = backend->prop(QStringLiteral("Drive"));
     if (!driveProp.isValid()) {
         return;
     }
 
     QDBusObjectPath drivePath = qdbus_cast<QDBusObjectPath>(driveProp);
-    DeviceBackend *driveBackend = DeviceBackend::backendForUDI(drivePath.path(), false);
+    const auto driveBackend = DeviceBackend::backendForUDI(drivePath.path(), false);
     if (!driveBackend) {
         return;
     }
@@ -31,22 +31,40 @@ public:
     QObject *createDevice(const QString &udi) override;
     QStringList devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type) override;
     QStringList allDevices() override;
+    // What the backend declares before it exists, for it to be created lazily
+    static QString staticUdiPrefix();
+    static QSet<Solid::DeviceInterface::Type> staticSupportedInterfaces();
+
     QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
     QString udiPrefix() const override;
+    bool notifiesMountPointChanges() const override;
+    QHash<quint64, QString> deviceNumbers() override;
     ~Manager() override;
 
+protected:
+    MatchResult matchNatively(const QString &udi, const Solid::Predicate &check) override;
+
 private Q_SLOTS:
-    void slotInterfacesAdded(const QDBusObjectPath &object_path, const VariantMapMap &interfaces_and_properties);
-    void slotInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
-    void slotMediaChanged(const QDBusMessage &msg);
+    void slotInterfacesAdded(const QString &udi, const VariantMapMap &interfaces_and_properties);
+    void slotInterfacesRemoved(const QString &udi, const QStringList &interfaces);
+    void slotPropertiesChanged(const QString &udi, const QString &ifaceName, const QVariantMap &changedProps, const QStringList &invalidatedProps);
+    void slotExclusionPolicyChanged();
 
 private:
     const QStringList &deviceCache();
+    bool enumerateManagedObjects();
     void introspect(const QString &path, bool checkOptical = false);
+    void addToDeviceCache(const QString &udi, bool checkOptical);
+    bool isExcluded(const QString &udi, const VariantMapMap &interfacesAndProperties) const;
     void updateBackend(const QString &udi);
+    void mediaChanged(const QString &udi, const QVariantMap &properties);
     QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
     org::freedesktop::DBus::ObjectManager m_manager;
     QStringList m_deviceCache;
+    // same as m_deviceCache, for lookups
+    QSet<QString> m_knownDevices;
+    // block devices which might hold an optical disc, whose media changes are tracked
+    QSet<QString> m_opticalDevices;
 };
 
 }
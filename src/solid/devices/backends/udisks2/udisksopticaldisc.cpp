@@ -6,134 +6,30 @@
 */
 
 #include "udisksopticaldisc.h"
-#include <fcntl.h>
-#include <sys/stat.h>
-#include <sys/types.h>
 #include <unistd.h>
 
 #include <QMap>
+#include <QPromise>
 #include <QSharedMemory>
 #include <QSystemSemaphore>
+#include <QThreadPool>
 #include <QThreadStorage>
 
+#include <solid/genericinterface.h>
+
+#include "../shared/discprober.h"
 #include "soliddefs_p.h"
 #include "udisks2.h"
 #include "udisks_debug.h"
 
-// inspired by http://cgit.freedesktop.org/hal/tree/hald/linux/probing/probe-volume.c
 static Solid::OpticalDisc::ContentType advancedDiscDetect(const QByteArray &device_file)
 {
-    /* the discs block size */
-    unsigned short bs;
-    /* the path table size */
-    unsigned short ts;
-    /* the path table location (in blocks) */
-    unsigned int tl;
-    /* length of the directory name in current path table entry */
-    unsigned char len_di = 0;
-    /* the number of the parent directory's path table entry */
-    unsigned int parent = 0;
-    /* filename for the current path table entry */
-    char dirname[256];
-    /* our position into the path table */
-    int pos = 0;
-    /* the path table record we're on */
-    int curr_record = 1;
-    /* import debug category */
     using Solid::Backends::UDisks2::UDISKS2;
 
-    Solid::OpticalDisc::ContentType result = Solid::OpticalDisc::NoContent;
-
-    int fd = open(device_file.constData(), O_RDONLY);
-
-    /* read the block size */
-    lseek(fd, 0x8080, SEEK_CUR);
-    if (read(fd, &bs, 2) != 2) {
-        qCDebug(UDISKS2, "Advanced probing on %s failed while reading block size", device_file.constData());
-        goto out;
-    }
-
-    /* read in size of path table */
-    lseek(fd, 2, SEEK_CUR);
-    if (read(fd, &ts, 2) != 2) {
-        qCDebug(UDISKS2, "Advanced probing on %s failed while reading path table size", device_file.constData());
-        goto out;
-    }
-
-    /* read in which block path table is in */
-    lseek(fd, 6, SEEK_CUR);
-    if (read(fd, &tl, 4) != 4) {
-        qCDebug(UDISKS2, "Advanced probing on %s failed while reading path table block", device_file.constData());
-        goto out;
-    }
-
-    /* seek to the path table */
-    lseek(fd, bs * tl, SEEK_SET);
-
-    /* loop through the path table entries */
-    while (pos < ts) {
-        /* get the length of the filename of the current entry */
-        if (read(fd, &len_di, 1) != 1) {
-            qCDebug(UDISKS2, "Advanced probing on %s failed, cannot read more entries", device_file.constData());
-            break;
-        }
-
-        /* get the record number of this entry's parent
-           i'm pretty sure that the 1st entry is always the top directory */
-        lseek(fd, 5, SEEK_CUR);
-        if (read(fd, &parent, 2) != 2) {
-            qCDebug(UDISKS2, "Advanced probing on %s failed, couldn't read parent entry", device_file.constData());
-            break;
-        }
-
-        /* read the name */
-        if (read(fd, dirname, len_di) != len_di) {
-            qCDebug(UDISKS2, "Advanced probing on %s failed, couldn't read the entry name", device_file.constData());
-            break;
-        }
-        dirname[len_di] = 0;
-
-        /* if we found a folder that has the root as a parent, and the directory name matches
-           one of the special directories then set the properties accordingly */
-        if (parent == 1) {
-            if (!strcasecmp(dirname, "VIDEO_TS")) {
-                qCDebug(UDISKS2, "Disc in %s is a Video DVD", device_file.constData());
-                result = Solid::OpticalDisc::VideoDvd;
-                break;
-            } else if (!strcasecmp(dirname, "BDMV")) {
-                qCDebug(UDISKS2, "Disc in %s is a Blu-ray video disc", device_file.constData());
-                result = Solid::OpticalDisc::VideoBluRay;
-                break;
-            } else if (!strcasecmp(dirname, "VCD")) {
-                qCDebug(UDISKS2, "Disc in %s is a Video CD", device_file.constData());
-                result = Solid::OpticalDisc::VideoCd;
-                break;
-            } else if (!strcasecmp(dirname, "SVCD")) {
-                qCDebug(UDISKS2, "Disc in %s is a Super Video CD", device_file.constData());
-                result = Solid::OpticalDisc::SuperVideoCd;
-                break;
-            }
-        }
-
-        /* all path table entries are padded to be even,
-           so if this is an odd-length table, seek a byte to fix it */
-        if (len_di % 2 == 1) {
-            lseek(fd, 1, SEEK_CUR);
-            pos++;
-        }
-
-        /* update our position */
-        pos += 8 + len_di;
-        curr_record++;
-    }
-
-    close(fd);
-    return result;
-
-out:
-    /* go back to the start of the file */
-    lseek(fd, 0, SEEK_SET);
-    close(fd);
+    // udisks2 hands out null terminated paths
+    const QByteArray path(device_file.constData());
+    const auto result = Solid::Backends::Shared::probeDiscContent(path);
+    qCDebug(UDISKS2) << "Disc in" << path << "has content" << result;
     return result;
 }
 
@@ -420,8 +316,19 @@ Solid::OpticalDisc::ContentTypes OpticalDisc::availableContent() const
 
         Identity newIdentity(*m_device, *m_drive);
         if (!(m_identity == newIdentity)) {
-            QByteArray deviceFile(m_device->prop(QStringLiteral("Device")).toByteArray());
-            m_cachedContent = sharedContentTypesCache->localData().getContent(newIdentity, deviceFile);
+            if (!m_probe.isValid() || !(m_probedIdentity == newIdentity)) {
+                startContentProbe(newIdentity);
+            }
+
+            // Until the probe is done only the track counts are known, the
+            // device reports a change of availableContent once it is
+            if (!m_probe.isFinished()) {
+                if (hasAudio) {
+                    content |= Solid::OpticalDisc::Audio;
+                }
+                return content;
+            }
+            m_cachedContent = m_probe.result();
             m_identity = newIdentity;
         }
 
@@ -434,6 +341,25 @@ Solid::OpticalDisc::ContentTypes OpticalDisc::availableContent() const
     return content;
 }
 
+void OpticalDisc::startContentProbe(const Identity &identity) const
+{
+    auto promise = std::make_shared<QPromise<Solid::OpticalDisc::ContentTypes>>();
+    m_probedIdentity = identity;
+    m_probe = promise->future();
+
+    Device *device = m_device;
+    m_probe.then(device, [device](Solid::OpticalDisc::ContentTypes) {
+        Q_EMIT device->propertyChanged({{QStringLiteral("availableContent"), Solid::GenericInterface::PropertyModified}});
+    });
+
+    const QByteArray deviceFile(m_device->prop(QStringLiteral("Device")).toByteArray());
+    QThreadPool::globalInstance()->start([promise, identity, deviceFile]() {
+        promise->start();
+        promise->addResult(sharedContentTypesCache->localData().getContent(identity, deviceFile));
+        promise->finish();
+    });
+}
+
 QString OpticalDisc::media() const
 {
     return m_drive->prop(QStringLiteral("Media")).toString();
@@ -16,6 +16,8 @@
 #include "udisksdevice.h"
 #include "udisksstoragevolume.h"
 
+#include <QFuture>
+
 namespace Solid
 {
 namespace Backends
@@ -52,7 +54,12 @@ public:
     };
 
 private:
+    // Detection of the video content, run on a worker thread
+    void startContentProbe(const Identity &identity) const;
+
     mutable Identity m_identity;
+    mutable Identity m_probedIdentity;
+    mutable QFuture<Solid::OpticalDisc::ContentTypes> m_probe;
     QString media() const;
     mutable Solid::OpticalDisc::ContentTypes m_cachedContent;
     Device *m_drive;
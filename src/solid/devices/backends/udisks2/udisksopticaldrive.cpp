@@ -15,6 +15,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
 #include <QDebug>
 #include <QFile>
 
@@ -22,6 +24,7 @@
 #include "udisks2.h"
 #include "udisks_debug.h"
 #include "udisksdevice.h"
+#include "udisksdevicebackend.h"
 
 using namespace Solid::Backends::UDisks2;
 
@@ -49,63 +52,150 @@ bool OpticalDrive::eject()
     m_ejectInProgress = true;
     m_device->broadcastActionRequested(QStringLiteral("eject"));
 
-    const QString path = m_device->udi();
-    QDBusConnection c = QDBusConnection::connectToBus(QDBusConnection::SystemBus, QStringLiteral("Solid::Udisks2::OpticalDrive::") + path);
-
-    // if the device is mounted, unmount first
-    QString blockPath;
-    org::freedesktop::DBus::ObjectManager manager(QStringLiteral(UD2_DBUS_SERVICE), QStringLiteral(UD2_DBUS_PATH), c);
-    QDBusPendingReply<DBUSManagerStruct> reply = manager.GetManagedObjects();
-    reply.waitForFinished();
-    if (!reply.isError()) { // enum devices
-        const auto objPathMap = reply.value();
-        for (auto it = objPathMap.cbegin(); it != objPathMap.cend(); ++it) {
-            const QString udi = it.key().path();
-
-            // qDebug() << "Inspecting" << udi;
-
-            if (udi == QLatin1String(UD2_DBUS_PATH_MANAGER) //
-                || udi == QLatin1String(UD2_UDI_DISKS_PREFIX) //
-                || udi.startsWith(QStringLiteral(UD2_DBUS_PATH_JOBS))) {
-                continue;
-            }
+    m_ejectTimer.start();
+    m_ejectLatency = Solid::OpticalDrive::EjectLatency();
+
+    // if the device is mounted, unmount first. The block devices of the drive are
+    // known to the backends as soon as the manager enumerated them.
+    const QStringList blockPaths = DeviceBackend::blockDevicesOfDrive(m_device->udi());
+    if (!blockPaths.isEmpty()) {
+        const QStringList mounted = mountedBlockDevices(blockPaths);
+        m_ejectLatency.lookup = m_ejectTimer.elapsed();
+        unmountAndEject(mounted);
+        return true;
+    }
 
-            Device device(udi);
-            if (device.drivePath() == path && device.isMounted()) {
-                // qDebug() << "Got mounted block device:" << udi;
-                blockPath = udi;
-                break;
-            }
+    // Nothing known about them in this process yet, a single asynchronous call
+    // tells which block devices of the drive are mounted
+    org::freedesktop::DBus::ObjectManager manager(QStringLiteral(UD2_DBUS_SERVICE), QStringLiteral(UD2_DBUS_PATH), QDBusConnection::systemBus());
+    auto watcher = new QDBusPendingCallWatcher(manager.GetManagedObjects(), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        m_ejectLatency.lookup = m_ejectTimer.elapsed();
+
+        const QDBusPendingReply<DBUSManagerStruct> reply = *call;
+        if (reply.isError()) {
+            // Eject anyway, UDisks2 refuses it if something is still mounted
+            qCWarning(UDISKS2) << "Failed enumerating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
+            unmountAndEject(QStringList());
+        } else {
+            unmountAndEject(mountedBlockDevices(reply.value()));
         }
-    } else { // show error
-        qCWarning(UDISKS2) << "Failed enumerating UDisks2 objects:" << reply.error().name() << "\n" << reply.error().message();
+    });
+
+    return true;
+}
+
+void OpticalDrive::unmountAndEject(const QStringList &blockPaths)
+{
+    if (blockPaths.isEmpty()) {
+        callEject();
+        return;
     }
 
-    if (!blockPath.isEmpty()) {
-        // qDebug() << "Calling unmount on" << blockPath;
+    // All of them at once, a disc may hold several mounted sessions or partitions
+    m_pendingUnmounts = blockPaths.size();
+    for (const QString &blockPath : blockPaths) {
         QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE),
                                                           blockPath,
                                                           QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM),
                                                           QStringLiteral("Unmount"));
         msg << QVariantMap(); // options, unused now
-        c.call(msg, QDBus::BlockWithGui);
+
+        auto watcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(msg), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, blockPath](QDBusPendingCallWatcher *call) {
+            call->deleteLater();
+
+            // The eject reports the failure, e.g. a busy device, if it matters
+            if (call->isError()) {
+                qCDebug(UDISKS2) << "Failed unmounting" << blockPath << "before ejecting:" << call->error().name() << call->error().message();
+            }
+
+            if (--m_pendingUnmounts == 0) {
+                m_ejectLatency.unmount = m_ejectTimer.elapsed() - m_ejectLatency.lookup;
+                callEject();
+            }
+        });
+    }
+}
+
+QStringList OpticalDrive::mountedBlockDevices(const QStringList &blockPaths) const
+{
+    QStringList mounted;
+    for (const QString &udi : blockPaths) {
+        const auto backend = DeviceBackend::backendForUDI(udi, false);
+        if (backend && !qdbus_cast<QByteArrayList>(backend->prop(QStringLiteral("MountPoints"))).isEmpty()) {
+            mounted.append(udi);
+        }
+    }
+
+    return mounted;
+}
+
+QStringList OpticalDrive::mountedBlockDevices(const DBUSManagerStruct &objects) const
+{
+    const QString path = m_device->udi();
+    const QString blockDevicesPath = QStringLiteral(UD2_DBUS_PATH_BLOCKDEVICES "/");
+
+    QStringList mounted;
+    for (auto it = objects.cbegin(); it != objects.cend(); ++it) {
+        const QString udi = it.key().path();
+        if (!udi.startsWith(blockDevicesPath)) {
+            continue;
+        }
+
+        // Spare the D-Bus calls to the backends created later on
+        DeviceBackend::preloadBackend(udi, it.value());
+
+        const QVariantMap block = it.value().value(QStringLiteral(UD2_DBUS_INTERFACE_BLOCK));
+        if (qdbus_cast<QDBusObjectPath>(block.value(QStringLiteral("Drive"))).path() != path) {
+            continue;
+        }
+
+        const QVariantMap filesystem = it.value().value(QStringLiteral(UD2_DBUS_INTERFACE_FILESYSTEM));
+        if (!qdbus_cast<QByteArrayList>(filesystem.value(QStringLiteral("MountPoints"))).isEmpty()) {
+            mounted.append(udi);
+        }
     }
 
-    QDBusMessage msg =
-        QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE), path, QStringLiteral(UD2_DBUS_INTERFACE_DRIVE), QStringLiteral("Eject"));
+    return mounted;
+}
+
+void OpticalDrive::callEject()
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral(UD2_DBUS_SERVICE),
+                                                      m_device->udi(),
+                                                      QStringLiteral(UD2_DBUS_INTERFACE_DRIVE),
+                                                      QStringLiteral("Eject"));
     msg << QVariantMap();
-    return c.callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)));
+
+    if (!QDBusConnection::systemBus().callWithCallback(msg, this, SLOT(slotDBusReply(QDBusMessage)), SLOT(slotDBusError(QDBusError)))) {
+        slotDBusError(QDBusConnection::systemBus().lastError());
+    }
+}
+
+Solid::OpticalDrive::EjectLatency OpticalDrive::lastEjectLatency() const
+{
+    return m_ejectLatency;
 }
 
 void OpticalDrive::slotDBusReply(const QDBusMessage & /*reply*/)
 {
     m_ejectInProgress = false;
+    m_ejectLatency.total = m_ejectTimer.elapsed();
+    m_ejectLatency.eject = m_ejectLatency.total - m_ejectLatency.lookup - qMax<qint64>(m_ejectLatency.unmount, 0);
+    qCDebug(UDISKS2) << "Ejected" << m_device->udi() << "in" << m_ejectLatency.total << "ms: lookup" << m_ejectLatency.lookup << "ms, unmount"
+                     << m_ejectLatency.unmount << "ms, eject" << m_ejectLatency.eject << "ms";
+
     m_device->broadcastActionDone(QStringLiteral("eject"));
 }
 
 void OpticalDrive::slotDBusError(const QDBusError &error)
 {
     m_ejectInProgress = false;
+    m_ejectLatency.total = m_ejectTimer.elapsed();
+    m_ejectLatency.eject = m_ejectLatency.total - m_ejectLatency.lookup - qMax<qint64>(m_ejectLatency.unmount, 0);
+
     m_device->broadcastActionDone(QStringLiteral("eject"), //
                                   m_device->errorToSolidError(error.name()),
                                   m_device->errorToString(error.name()) + QStringLiteral(": ") + error.message());
@@ -11,6 +11,8 @@
 #include "udisksstoragedrive.h"
 #include <solid/devices/ifaces/opticaldrive.h>
 
+#include <QElapsedTimer>
+
 namespace Solid
 {
 namespace Backends
@@ -33,6 +35,7 @@ Q_SIGNALS:
 
 public:
     bool eject() override;
+    Solid::OpticalDrive::EjectLatency lastEjectLatency() const override;
     QList<int> writeSpeeds() const override;
     int writeSpeed() const override;
     int readSpeed() const override;
@@ -49,8 +52,16 @@ private Q_SLOTS:
 
 private:
     void initReadWriteSpeeds() const;
+    QStringList mountedBlockDevices(const QStringList &blockPaths) const;
+    QStringList mountedBlockDevices(const DBUSManagerStruct &objects) const;
+    void unmountAndEject(const QStringList &blockPaths);
+    void callEject();
 
     bool m_ejectInProgress;
+    // Unmount calls of the eject in progress still waiting for their reply
+    int m_pendingUnmounts = 0;
+    QElapsedTimer m_ejectTimer;
+    Solid::OpticalDrive::EjectLatency m_ejectLatency;
 
     // read/write speeds
     mutable int m_readSpeed;
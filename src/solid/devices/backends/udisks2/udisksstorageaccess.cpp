@@ -56,6 +56,8 @@ StorageAccess::StorageAccess(Device *device)
     qDBusRegisterMetaType<AvailableAnswer>();
 
     connect(device, SIGNAL(changed()), this, SLOT(checkAccessibility()));
+    connect(device, &Device::jobChanged, this, &StorageAccess::slotJobChanged);
+    connect(device, &Device::jobCompleted, this, &StorageAccess::slotJobCompleted);
     updateCache();
 
     // Delay connecting to DBus signals to avoid the related time penalty
@@ -291,6 +293,23 @@ bool StorageAccess::setup()
     }
 }
 
+bool StorageAccess::setupWithPassphrase(const QString &passphrase)
+{
+    if (m_teardownInProgress || m_setupInProgress || m_checkInProgress || m_repairInProgress) {
+        return false;
+    }
+    m_setupInProgress = true;
+    m_device->broadcastActionRequested(QStringLiteral("setup"));
+
+    if (m_device->isEncryptedContainer() && clearTextPath().isEmpty()) {
+        // mounted by slotDBusReply() once unlocked
+        callCryptoSetup(passphrase);
+        return true;
+    } else {
+        return mount();
+    }
+}
+
 bool StorageAccess::teardown()
 {
     if (m_teardownInProgress || m_setupInProgress || m_checkInProgress || m_repairInProgress) {
@@ -317,6 +336,31 @@ void StorageAccess::checkAccessibility()
     }
 }
 
+void StorageAccess::slotJobChanged(const QString &jobPath, const QVariantMap &properties)
+{
+    if (!m_jobs.contains(jobPath)) {
+        m_jobs.insert(jobPath);
+        Q_EMIT jobStarted(properties.value(QStringLiteral("Operation")).toString(), m_device->udi());
+    }
+
+    const double progress = properties.value(QStringLiteral("ProgressValid")).toBool() ? properties.value(QStringLiteral("Progress")).toDouble() : -1.0;
+    // microseconds since the Epoch, 0 if unknown
+    const qulonglong expectedEndTime = properties.value(QStringLiteral("ExpectedEndTime")).toULongLong();
+
+    Q_EMIT jobProgressChanged(progress,
+                              properties.value(QStringLiteral("Rate")).toULongLong(),
+                              expectedEndTime ? QDateTime::fromMSecsSinceEpoch(expectedEndTime / 1000) : QDateTime(),
+                              properties.value(QStringLiteral("Bytes")).toULongLong(),
+                              m_device->udi());
+}
+
+void StorageAccess::slotJobCompleted(const QString &jobPath, bool success, const QString &message)
+{
+    if (m_jobs.remove(jobPath)) {
+        Q_EMIT jobFinished(success, message, m_device->udi());
+    }
+}
+
 void StorageAccess::slotDBusReply(const QDBusMessage &reply)
 {
     if (m_setupInProgress) {
@@ -13,6 +13,7 @@
 
 #include <QDBusError>
 #include <QDBusMessage>
+#include <QSet>
 
 namespace Solid
 {
@@ -33,6 +34,7 @@ public:
     QString filePath() const override;
     bool isIgnored() const override;
     bool setup() override;
+    bool setupWithPassphrase(const QString &passphrase) override;
     bool teardown() override;
     bool isEncrypted() const override;
 
@@ -51,6 +53,9 @@ Q_SIGNALS:
     void checkDone(Solid::ErrorType error, QVariant errorData, const QString &udi) override;
     void repairRequested(const QString &udi) override;
     void repairDone(Solid::ErrorType error, QVariant errorData, const QString &udi) override;
+    void jobStarted(const QString &operation, const QString &udi) override;
+    void jobProgressChanged(double progress, qulonglong rate, const QDateTime &expectedEndTime, qulonglong bytes, const QString &udi) override;
+    void jobFinished(bool success, const QString &message, const QString &udi) override;
 
 public Q_SLOTS:
     Q_SCRIPTABLE Q_NOREPLY void passphraseReply(const QString &passphrase);
@@ -72,6 +77,9 @@ private Q_SLOTS:
 
     void checkAccessibility();
 
+    void slotJobChanged(const QString &jobPath, const QVariantMap &properties);
+    void slotJobCompleted(const QString &jobPath, bool success, const QString &message);
+
 private:
     /// @return true if this device is luks and unlocked
     bool isLuksDevice() const;
@@ -98,6 +106,8 @@ private:
     bool m_repairInProgress;
     bool m_passphraseRequested;
     QString m_lastReturnObject;
+    // UDisks2 jobs running on this device
+    QSet<QString> m_jobs;
 
     static const int s_unmountTimeout = 0x7fffffff;
 };
@@ -21,7 +21,7 @@ using namespace Solid::Backends::Shared;
 
 UPowerManager::UPowerManager(QObject *parent)
     : Solid::Ifaces::DeviceManager(parent)
-    , m_supportedInterfaces({Solid::DeviceInterface::GenericInterface, Solid::DeviceInterface::Battery})
+    , m_supportedInterfaces(staticSupportedInterfaces())
     , m_manager(QDBusConnection::systemBus())
     , m_knownDevices(udiPrefix())
 {
@@ -146,11 +146,21 @@ QSet<Solid::DeviceInterface::Type> UPowerManager::supportedInterfaces() const
     return m_supportedInterfaces;
 }
 
-QString UPowerManager::udiPrefix() const
+QString UPowerManager::staticUdiPrefix()
 {
     return QStringLiteral(UP_UDI_PREFIX);
 }
 
+QSet<Solid::DeviceInterface::Type> UPowerManager::staticSupportedInterfaces()
+{
+    return {Solid::DeviceInterface::GenericInterface, Solid::DeviceInterface::Battery};
+}
+
+QString UPowerManager::udiPrefix() const
+{
+    return staticUdiPrefix();
+}
+
 void UPowerManager::onDeviceAdded(const QDBusObjectPath &path)
 {
     auto pathString = path.path();
@@ -30,6 +30,10 @@ public:
     QObject *createDevice(const QString &udi) override;
     QStringList devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type) override;
     QStringList allDevices() override;
+    // What the backend declares before it exists, for it to be created lazily
+    static QString staticUdiPrefix();
+    static QSet<Solid::DeviceInterface::Type> staticSupportedInterfaces();
+
     QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
     QString udiPrefix() const override;
 
@@ -7,6 +7,7 @@
 #ifndef SOLID_DEVICE_H
 #define SOLID_DEVICE_H
 
+#include <QFuture>
 #include <QList>
 #include <QSharedData>
 
@@ -74,6 +75,60 @@ public:
      */
     static QList<Device> listFromQuery(const QString &predicate, const QString &parentUdi = QString());
 
+    /**
+     * Asynchronous version of allDevices().
+     *
+     * The backends are enumerated concurrently, each in a thread of its own,
+     * and the result is delivered through the event loop of the calling
+     * thread: the future only finishes while that event loop runs. Waiting for
+     * it from the calling thread, with QFuture::result() or
+     * QFuture::waitForFinished(), never returns, use QFuture::then() or a
+     * QFutureWatcher instead.
+     *
+     * @return a future providing the list of the devices available
+     * @since 6.13
+     */
+    static QFuture<QList<Device>> allDevicesAsync();
+
+    /**
+     * Asynchronous version of listFromType().
+     *
+     * @param type device interface type available on the devices we're looking for, or DeviceInterface::Unknown
+     * if there's no constraint on the device interfaces
+     * @param parentUdi UDI of the parent of the devices we're searching for, or QString()
+     * if there's no constraint on the parent
+     * @return a future providing the list of devices corresponding to the given constraints
+     * @see allDevicesAsync()
+     * @since 6.13
+     */
+    static QFuture<QList<Device>> listFromTypeAsync(const DeviceInterface::Type &type, const QString &parentUdi = QString());
+
+    /**
+     * Asynchronous version of listFromQuery().
+     *
+     * The backends rule out the devices which can't match the predicate in
+     * their threads, the remaining ones are checked against it in the calling
+     * thread.
+     *
+     * @param predicate Predicate that the devices we're searching for must verify
+     * @param parentUdi UDI of the parent of the devices we're searching for, or QString()
+     * if there's no constraint on the parent
+     * @return a future providing the list of devices corresponding to the given constraints
+     * @see allDevicesAsync()
+     * @since 6.13
+     */
+    static QFuture<QList<Device>> listFromQueryAsync(const Predicate &predicate, const QString &parentUdi = QString());
+
+    /**
+     * Convenience function see above.
+     *
+     * @param predicate
+     * @param parentUdi
+     * @return a future providing the list of devices
+     * @since 6.13
+     */
+    static QFuture<QList<Device>> listFromQueryAsync(const QString &predicate, const QString &parentUdi = QString());
+
     /**
      * Returns the Device containing the filesystem for the given path
      *
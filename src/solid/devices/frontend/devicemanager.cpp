@@ -17,10 +17,18 @@
 #include "ifaces/device.h"
 #include "ifaces/devicemanager.h"
 
+#include "sharedbackends_p.h"
 #include "soliddefs_p.h"
 
+#include <QFile>
 #include <QLoggingCategory>
+#include <QMetaMethod>
+#include <QThread>
+#include <qplatformdefs.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <set>
 
 Q_GLOBAL_STATIC(Solid::DeviceManagerStorage, globalDeviceStorage)
@@ -30,19 +38,18 @@ Solid::DeviceManagerPrivate::DeviceManagerPrivate()
 {
     loadBackends();
 
-    const auto backends = managerBackends();
-    for (const auto &backend : backends) {
-        connect(backend, &Solid::Ifaces::DeviceManager::deviceAdded, this, &Solid::DeviceManagerPrivate::_k_deviceAdded);
-        connect(backend, &Solid::Ifaces::DeviceManager::deviceRemoved, this, &Solid::DeviceManagerPrivate::_k_deviceRemoved);
-    }
+    m_changesTimer.setSingleShot(true);
+    m_changesTimer.setInterval(100);
+    connect(&m_changesTimer, &QTimer::timeout, this, &DeviceManagerPrivate::_k_flushChanges);
 }
 
 Solid::DeviceManagerPrivate::~DeviceManagerPrivate()
 {
-    const auto backends = managerBackends();
+    const auto backends = loadedBackends();
     for (const auto &backend : backends) {
         disconnect(backend, &Solid::Ifaces::DeviceManager::deviceAdded, this, &Solid::DeviceManagerPrivate::_k_deviceAdded);
         disconnect(backend, &Solid::Ifaces::DeviceManager::deviceRemoved, this, &Solid::DeviceManagerPrivate::_k_deviceRemoved);
+        disconnect(backend, &Solid::Ifaces::DeviceManager::deviceChanged, this, &Solid::DeviceManagerPrivate::_k_deviceChanged);
     }
 
     // take a copy as m_devicesMap is changed by Solid::DeviceManagerPrivate::_k_destroyed
@@ -56,6 +63,82 @@ Solid::DeviceManagerPrivate::~DeviceManagerPrivate()
     m_devicesMap.clear();
 }
 
+namespace
+{
+// Returns the UDIs of @p backend's devices which might verify @p predicate, as far
+// as the backend can tell without a Device, every device if it is invalid
+QStringList candidateUdis(Solid::Ifaces::DeviceManager *backend, const Solid::Predicate &predicate, const QString &parentUdi)
+{
+    QStringList udis;
+    if (predicate.isValid()) {
+        auto supportedTypes = backend->supportedInterfaces();
+        if (supportedTypes.intersect(predicate.usedTypes()).isEmpty()) {
+            return QStringList();
+        }
+
+        auto sortedTypes = supportedTypes.values();
+        std::sort(sortedTypes.begin(), sortedTypes.end());
+        for (const auto &type : std::as_const(sortedTypes)) {
+            udis += backend->devicesFromQuery(parentUdi, type);
+        }
+    } else {
+        udis = backend->allDevices();
+    }
+
+    QStringList result;
+    std::set<QString> seen;
+    for (const auto &udi : std::as_const(udis)) {
+        const auto [it, isInserted] = seen.insert(udi);
+        if (!isInserted) {
+            continue;
+        }
+        if (!predicate.isValid() || backend->mightMatch(udi, predicate)) {
+            result << udi;
+        }
+    }
+
+    return result;
+}
+
+// Runs @p query against every backend providing one of @p types, or every backend
+// if @p types is empty, each in the thread of the instance of that backend shared
+// by the process, so the backends are enumerated concurrently without any other
+// thread building a device manager of its own. Only UDIs cross threads: the Device
+// objects are built, and checked with @p filter, in the calling thread once all
+// backends are done, in backend order. This needs the event loop of the calling
+// thread.
+QFuture<QList<Solid::Device>> queryBackendsAsync(const QSet<Solid::DeviceInterface::Type> &types,
+                                                 const std::function<QStringList(Solid::Ifaces::DeviceManager *)> &query,
+                                                 const std::function<bool(const Solid::Device &)> &filter = {})
+{
+    const QStringList names = globalDeviceStorage->backendNames(types);
+
+    QList<QFuture<QStringList>> futures;
+    futures.reserve(names.size());
+    for (const QString &name : names) {
+        const QFuture<Solid::Ifaces::DeviceManager *> backend = globalDeviceStorage->sharedBackend(name);
+        futures.append(backend.then(Solid::SharedBackends::instance()->context(name), [query](Solid::Ifaces::DeviceManager *backend) {
+            return backend ? query(backend) : QStringList();
+        }));
+    }
+
+    QObject *context = globalDeviceStorage->notifier();
+    return QtFuture::whenAll(futures.begin(), futures.end()).then(context, [filter](const QList<QFuture<QStringList>> &results) {
+        QList<Solid::Device> list;
+        for (const auto &result : results) {
+            const QStringList udis = result.result();
+            for (const auto &udi : udis) {
+                const Solid::Device device(udi);
+                if (!filter || filter(device)) {
+                    list.append(device);
+                }
+            }
+        }
+        return list;
+    });
+}
+}
+
 QList<Solid::Device> Solid::Device::allDevices()
 {
     QList<Device> list;
@@ -85,13 +168,20 @@ QList<Solid::Device> Solid::Device::listFromQuery(const QString &predicate, cons
 QList<Solid::Device> Solid::Device::listFromType(const DeviceInterface::Type &type, const QString &parentUdi)
 {
     QList<Device> list;
-    const auto backends = globalDeviceStorage->managerBackends();
 
-    for (const auto &backend : backends) {
-        if (!backend->supportedInterfaces().contains(type)) {
-            continue;
+    DeviceManagerPrivate *manager = static_cast<DeviceManagerPrivate *>(globalDeviceStorage->notifier());
+    if (parentUdi.isEmpty() && manager->isTypeIndexUsable()) {
+        const QStringList udis = manager->devicesOfType(type);
+        list.reserve(udis.size());
+        for (const auto &udi : udis) {
+            list.append(Device(udi));
         }
+        return list;
+    }
+
+    const auto backends = globalDeviceStorage->managerBackends({type});
 
+    for (const auto &backend : backends) {
         const auto udis = backend->devicesFromQuery(parentUdi, type);
         for (const auto &udi : udis) {
             list.append(Device(udi));
@@ -105,42 +195,34 @@ QList<Solid::Device> Solid::Device::listFromQuery(const Predicate &predicate, co
 {
     QList<Device> list;
     const auto usedTypes = predicate.usedTypes();
-    const auto backends = globalDeviceStorage->managerBackends();
 
-    for (const auto &backend : backends) {
-        QStringList udis;
-        if (predicate.isValid()) {
-            auto supportedTypes = backend->supportedInterfaces();
-            if (supportedTypes.intersect(usedTypes).isEmpty()) {
+    DeviceManagerPrivate *manager = static_cast<DeviceManagerPrivate *>(globalDeviceStorage->notifier());
+    if (predicate.isValid() && parentUdi.isEmpty() && manager->isTypeIndexUsable()) {
+        // A matching device necessarily provides one of the types used in the predicate,
+        // so the candidates are the union of the indexed devices of those types
+        const QStringList candidates = manager->devicesOfTypes(usedTypes);
+
+        for (const auto &udi : candidates) {
+            Ifaces::DeviceManager *backend = manager->backendForUdi(udi);
+            if (backend && !backend->mightMatch(udi, predicate)) {
                 continue;
             }
 
-            auto sortedTypes = supportedTypes.values();
-            std::sort(sortedTypes.begin(), sortedTypes.end());
-            for (const auto &type : std::as_const(sortedTypes)) {
-                udis += backend->devicesFromQuery(parentUdi, type);
+            const Device dev(udi);
+            if (predicate.matches(dev)) {
+                list.append(dev);
             }
-        } else {
-            udis += backend->allDevices();
         }
+        return list;
+    }
 
-        std::set<QString> seen;
-        for (const auto &udi : std::as_const(udis)) {
-            const auto [it, isInserted] = seen.insert(udi);
-            if (!isInserted) {
-                continue;
-            }
-            const Device dev(udi);
-
-            bool matches = false;
-
-            if (!predicate.isValid()) {
-                matches = true;
-            } else {
-                matches = predicate.matches(dev);
-            }
+    const auto backends = predicate.isValid() ? globalDeviceStorage->managerBackends(usedTypes) : globalDeviceStorage->managerBackends();
 
-            if (matches) {
+    for (const auto &backend : backends) {
+        const auto udis = candidateUdis(backend, predicate, parentUdi);
+        for (const auto &udi : udis) {
+            const Device dev(udi);
+            if (!predicate.isValid() || predicate.matches(dev)) {
                 list.append(dev);
             }
         }
@@ -149,8 +231,56 @@ QList<Solid::Device> Solid::Device::listFromQuery(const Predicate &predicate, co
     return list;
 }
 
+QFuture<QList<Solid::Device>> Solid::Device::allDevicesAsync()
+{
+    return queryBackendsAsync({}, [](Ifaces::DeviceManager *backend) {
+        return backend->allDevices();
+    });
+}
+
+QFuture<QList<Solid::Device>> Solid::Device::listFromTypeAsync(const DeviceInterface::Type &type, const QString &parentUdi)
+{
+    return queryBackendsAsync({type}, [type, parentUdi](Ifaces::DeviceManager *backend) {
+        return backend->devicesFromQuery(parentUdi, type);
+    });
+}
+
+QFuture<QList<Solid::Device>> Solid::Device::listFromQueryAsync(const Predicate &predicate, const QString &parentUdi)
+{
+    if (!predicate.isValid()) {
+        return queryBackendsAsync({}, [parentUdi](Ifaces::DeviceManager *backend) {
+            return candidateUdis(backend, Predicate(), parentUdi);
+        });
+    }
+
+    return queryBackendsAsync(
+        predicate.usedTypes(),
+        [predicate, parentUdi](Ifaces::DeviceManager *backend) {
+            return candidateUdis(backend, predicate, parentUdi);
+        },
+        [predicate](const Device &device) {
+            return predicate.matches(device);
+        });
+}
+
+QFuture<QList<Solid::Device>> Solid::Device::listFromQueryAsync(const QString &predicate, const QString &parentUdi)
+{
+    Predicate p = Predicate::fromString(predicate);
+
+    if (p.isValid()) {
+        return listFromQueryAsync(p, parentUdi);
+    } else {
+        return QtFuture::makeReadyValueFuture(QList<Device>());
+    }
+}
+
 Solid::Device Solid::Device::storageAccessFromPath(const QString &path)
 {
+    auto manager = static_cast<DeviceManagerPrivate *>(globalDeviceStorage->notifier());
+    if (const auto udi = manager->storageAccessUdiForPath(path)) {
+        return udi->isEmpty() ? Device() : Device(*udi);
+    }
+
     const QList<Device> list = Solid::Device::listFromType(DeviceInterface::Type::StorageAccess);
     Device match;
     int match_length = 0;
@@ -188,6 +318,21 @@ Solid::DeviceNotifier *Solid::DeviceNotifier::instance()
     return globalDeviceStorage->notifier();
 }
 
+void Solid::DeviceNotifier::setCoalescingInterval(int msecs)
+{
+    static_cast<DeviceManagerPrivate *>(this)->m_changesTimer.setInterval(msecs);
+}
+
+int Solid::DeviceNotifier::coalescingInterval() const
+{
+    return static_cast<const DeviceManagerPrivate *>(this)->m_changesTimer.interval();
+}
+
+QHash<QString, qint64> Solid::DeviceNotifier::backendStartupTimes() const
+{
+    return static_cast<const DeviceManagerPrivate *>(this)->ManagerBasePrivate::backendStartupTimes();
+}
+
 void Solid::DeviceManagerPrivate::_k_deviceAdded(const QString &udi)
 {
     if (m_devicesMap.contains(udi)) {
@@ -202,6 +347,13 @@ void Solid::DeviceManagerPrivate::_k_deviceAdded(const QString &udi)
         }
     }
 
+    Ifaces::DeviceManager *backend = backendForUdi(udi);
+    ++m_generations[backend];
+
+    invalidateMountPoints(backend);
+
+    recordChange(udi, Change::Added);
+
     Q_EMIT deviceAdded(udi);
 }
 
@@ -219,7 +371,102 @@ void Solid::DeviceManagerPrivate::_k_deviceRemoved(const QString &udi)
         }
     }
 
+    unindexDevice(udi);
+
+    invalidateMountPoints(backendForUdi(udi));
+
+    recordChange(udi, Change::Removed);
+
+    Q_EMIT deviceRemoved(udi);
+}
+
+void Solid::DeviceManagerPrivate::_k_deviceChanged(const QString &udi)
+{
+    if (m_devicesMap.contains(udi)) {
+        DevicePrivate *dev = m_devicesMap[udi].data();
+
+        // Drop the interfaces created so far, they may not be provided anymore
+        if (dev && dev->backendObject() != nullptr) {
+            dev->setBackendObject(createBackendObject(udi));
+        }
+    }
+
+    Ifaces::DeviceManager *backend = backendForUdi(udi);
+    ++m_generations[backend];
+
+    invalidateMountPoints(backend);
+
+    recordChange(udi, Change::Modified);
+
+    // Per-device listeners used to see such a device go and come back, and
+    // re-evaluate it on that, keep it that way for them
+    m_reannouncing = true;
     Q_EMIT deviceRemoved(udi);
+    Q_EMIT deviceAdded(udi);
+    m_reannouncing = false;
+
+    Q_EMIT deviceChanged(udi);
+}
+
+bool Solid::DeviceManagerPrivate::isReannouncing() const
+{
+    return m_reannouncing;
+}
+
+void Solid::DeviceManagerPrivate::recordChange(const QString &udi, Change change)
+{
+    if (!isSignalConnected(QMetaMethod::fromSignal(&DeviceNotifier::devicesChanged))) {
+        return;
+    }
+
+    auto it = m_pendingChanges.find(udi);
+    if (it == m_pendingChanges.end()) {
+        m_pendingChanges.insert(udi, change);
+    } else if (change == Change::Added && it.value() == Change::Removed) {
+        // Still there, backends re-announce devices whose interfaces changed
+        it.value() = Change::Modified;
+    } else if (change == Change::Removed && it.value() == Change::Added) {
+        // Came and went, nobody needs to hear about it
+        m_pendingChanges.erase(it);
+    } else if (change == Change::Removed) {
+        it.value() = Change::Removed;
+    }
+
+    if (!m_changesTimer.isActive()) {
+        m_changesTimer.start();
+    }
+}
+
+void Solid::DeviceManagerPrivate::_k_flushChanges()
+{
+    QStringList added;
+    QStringList removed;
+    QStringList modified;
+
+    for (auto it = m_pendingChanges.cbegin(); it != m_pendingChanges.cend(); ++it) {
+        switch (it.value()) {
+        case Change::Added:
+            added << it.key();
+            break;
+        case Change::Removed:
+            removed << it.key();
+            break;
+        case Change::Modified:
+            modified << it.key();
+            break;
+        }
+    }
+    m_pendingChanges.clear();
+
+    if (added.isEmpty() && removed.isEmpty() && modified.isEmpty()) {
+        return;
+    }
+
+    std::sort(added.begin(), added.end());
+    std::sort(removed.begin(), removed.end());
+    std::sort(modified.begin(), modified.end());
+
+    Q_EMIT devicesChanged(added, removed, modified);
 }
 
 void Solid::DeviceManagerPrivate::_k_destroyed(QObject *object)
@@ -255,26 +502,216 @@ Solid::DevicePrivate *Solid::DeviceManagerPrivate::findRegisteredDevice(const QS
 
 Solid::Ifaces::Device *Solid::DeviceManagerPrivate::createBackendObject(const QString &udi)
 {
-    const auto backends = globalDeviceStorage->managerBackends();
+    Ifaces::DeviceManager *backend = backendForUdi(udi);
+
+    if (backend == nullptr) {
+        return nullptr;
+    }
+
+    Ifaces::Device *iface = nullptr;
+
+    QObject *object = backend->createDevice(udi);
+    iface = qobject_cast<Ifaces::Device *>(object);
+
+    if (iface == nullptr) {
+        delete object;
+    }
+
+    return iface;
+}
+
+Solid::Ifaces::DeviceManager *Solid::DeviceManagerPrivate::backendForUdi(const QString &udi)
+{
+    return managerBackendForUdi(udi);
+}
 
+void Solid::DeviceManagerPrivate::backendLoaded(Ifaces::DeviceManager *backend)
+{
+    connect(backend, &Solid::Ifaces::DeviceManager::deviceAdded, this, &Solid::DeviceManagerPrivate::_k_deviceAdded);
+    connect(backend, &Solid::Ifaces::DeviceManager::deviceRemoved, this, &Solid::DeviceManagerPrivate::_k_deviceRemoved);
+    connect(backend, &Solid::Ifaces::DeviceManager::deviceChanged, this, &Solid::DeviceManagerPrivate::_k_deviceChanged);
+    connect(backend, &Solid::Ifaces::DeviceManager::mountPointsChanged, this, [this, backend]() {
+        invalidateMountPoints(backend);
+    });
+}
+
+std::optional<QString> Solid::DeviceManagerPrivate::storageAccessUdiForPath(const QString &path)
+{
+    const auto backends = managerBackends({DeviceInterface::Type::StorageAccess});
     for (const auto &backend : backends) {
-        if (!udi.startsWith(backend->udiPrefix())) {
-            continue;
+        // Without notifications a cached table could go stale unnoticed
+        if (!backend->notifiesMountPointChanges()) {
+            return std::nullopt;
+        }
+    }
+
+    if (!m_mountPointTrieValid) {
+        QList<std::pair<QString, QString>> entries;
+        QList<std::pair<QString, quint64>> deviceNumbers;
+        // Same precedence as the linear scan over listFromType(): the first
+        // backend wins, and within a backend the first UDI
+        for (const auto &backend : backends) {
+            const auto backendEntries = entries.size();
+            const auto backendDeviceNumbers = deviceNumbers.size();
+            if (!m_mountPoints.contains(backend) || m_staleMountPoints.contains(backend)) {
+                m_mountPoints.insert(backend, backend->mountPoints());
+                m_deviceNumbers.insert(backend, backend->deviceNumbers());
+                if (backend->supportedInterfaces().contains(DeviceInterface::NetworkShare)) {
+                    const QStringList shares = backend->devicesFromQuery(QString(), DeviceInterface::NetworkShare);
+                    m_networkShares.insert(backend, QSet<QString>(shares.begin(), shares.end()));
+                }
+                m_staleMountPoints.remove(backend);
+            }
+
+            const auto &mountPoints = m_mountPoints[backend];
+            for (auto entry = mountPoints.cbegin(); entry != mountPoints.cend(); ++entry) {
+                entries.append({entry.key(), entry.value()});
+            }
+
+            const auto &numbers = m_deviceNumbers[backend];
+            for (auto entry = numbers.cbegin(); entry != numbers.cend(); ++entry) {
+                deviceNumbers.append({entry.value(), entry.key()});
+            }
+
+            std::sort(entries.begin() + backendEntries, entries.end());
+            std::sort(deviceNumbers.begin() + backendDeviceNumbers, deviceNumbers.end());
+        }
+
+        m_mountPointTrie.clear();
+        for (const auto &[udi, mountPoint] : std::as_const(entries)) {
+            m_mountPointTrie.insert(mountPoint, udi);
+        }
+
+        m_deviceNumberIndex.clear();
+        for (const auto &[udi, deviceNumber] : std::as_const(deviceNumbers)) {
+            m_deviceNumberIndex.insert(deviceNumber, m_deviceNumberIndex.value(deviceNumber, udi));
+        }
+        m_mountPointTrieValid = true;
+    }
+
+    const QString udi = m_mountPointTrie.find(path);
+
+    // stat() may hang on a dead network mount, the path alone has to tell for those
+    if (!udi.isEmpty()) {
+        const auto backend = backendForUdi(udi);
+        if (backend && m_networkShares.value(backend).contains(udi)) {
+            return udi;
+        }
+    }
+
+#ifdef Q_OS_UNIX
+    if (!m_deviceNumberIndex.isEmpty()) {
+        QT_STATBUF sb;
+        if (QT_STAT(QFile::encodeName(path).constData(), &sb) == 0) {
+            const auto it = m_deviceNumberIndex.constFind(sb.st_dev);
+            if (it != m_deviceNumberIndex.constEnd()) {
+                return it.value();
+            }
         }
+    }
+#endif
+
+    return udi;
+}
+
+void Solid::DeviceManagerPrivate::invalidateMountPoints(Ifaces::DeviceManager *backend)
+{
+    if (backend) {
+        m_staleMountPoints.insert(backend);
+    }
+    m_mountPointTrieValid = false;
+}
+
+void Solid::DeviceManagerPrivate::connectNotify(const QMetaMethod &signal)
+{
+    // Listeners expect to hear about every device, so the lazily created backends
+    // can't wait any longer
+    if (signal == QMetaMethod::fromSignal(&DeviceNotifier::deviceAdded) || signal == QMetaMethod::fromSignal(&DeviceNotifier::deviceRemoved)
+        || signal == QMetaMethod::fromSignal(&DeviceNotifier::devicesChanged)) {
+        managerBackends();
+    }
 
-        Ifaces::Device *iface = nullptr;
+    DeviceNotifier::connectNotify(signal);
+}
+
+bool Solid::DeviceManagerPrivate::isTypeIndexUsable() const
+{
+    // The index is neither shared nor locked
+    return thread() == QThread::currentThread();
+}
+
+QStringList Solid::DeviceManagerPrivate::devicesOfType(DeviceInterface::Type type)
+{
+    return devicesOfTypes({type});
+}
 
-        QObject *object = backend->createDevice(udi);
-        iface = qobject_cast<Ifaces::Device *>(object);
+QStringList Solid::DeviceManagerPrivate::devicesOfTypes(const QSet<DeviceInterface::Type> &types)
+{
+    QStringList result;
+    QSet<QString> seen;
+
+    // Same order as the live enumeration, see candidateUdis()
+    auto sortedTypes = types.values();
+    std::sort(sortedTypes.begin(), sortedTypes.end());
+
+    // Only the backends providing the types get created
+    const auto backends = managerBackends(types);
+    for (const auto &backend : backends) {
+        const auto supportedTypes = backend->supportedInterfaces();
+        for (const auto &type : std::as_const(sortedTypes)) {
+            if (!supportedTypes.contains(type)) {
+                continue;
+            }
 
-        if (iface == nullptr) {
-            delete object;
+            const QStringList &udis = indexedDevices(backend, type);
+            for (const QString &udi : udis) {
+                // a device is often of several of the types
+                if (types.size() > 1) {
+                    if (seen.contains(udi)) {
+                        continue;
+                    }
+                    seen.insert(udi);
+                }
+                result.append(udi);
+            }
         }
+    }
+
+    return result;
+}
 
-        return iface;
+const QStringList &Solid::DeviceManagerPrivate::indexedDevices(Ifaces::DeviceManager *backend, DeviceInterface::Type type)
+{
+    const quint64 generation = backendGeneration(backend);
+
+    auto &backendIndex = m_typeIndex[type];
+    auto it = backendIndex.find(backend);
+    if (it == backendIndex.end() || it->generation != generation) {
+        // Listing the devices again keeps them in the order of the backend
+        const QStringList udis = backend->devicesFromQuery(QString(), type);
+        it = backendIndex.insert(backend, TypeIndex{udis, generation});
     }
 
-    return nullptr;
+    return it->udis;
+}
+
+quint64 Solid::DeviceManagerPrivate::backendGeneration(Ifaces::DeviceManager *backend) const
+{
+    // The notifications of a shared backend reach this thread later on
+    const auto proxy = qobject_cast<BackendProxy *>(backend);
+    return m_generations.value(backend) + (proxy ? proxy->generation() : 0);
+}
+
+void Solid::DeviceManagerPrivate::unindexDevice(const QString &udi)
+{
+    Ifaces::DeviceManager *backend = backendForUdi(udi);
+
+    for (auto &backendIndex : m_typeIndex) {
+        auto it = backendIndex.find(backend);
+        if (it != backendIndex.end()) {
+            it->udis.removeOne(udi);
+        }
+    }
 }
 
 Solid::DeviceManagerStorage::DeviceManagerStorage()
@@ -287,6 +724,24 @@ QList<Solid::Ifaces::DeviceManager *> Solid::DeviceManagerStorage::managerBacken
     return m_storage.localData()->managerBackends();
 }
 
+QList<Solid::Ifaces::DeviceManager *> Solid::DeviceManagerStorage::managerBackends(const QSet<DeviceInterface::Type> &types)
+{
+    ensureManagerCreated();
+    return m_storage.localData()->managerBackends(types);
+}
+
+QStringList Solid::DeviceManagerStorage::backendNames(const QSet<DeviceInterface::Type> &types)
+{
+    ensureManagerCreated();
+    return m_storage.localData()->backendNames(types);
+}
+
+QFuture<Solid::Ifaces::DeviceManager *> Solid::DeviceManagerStorage::sharedBackend(const QString &name)
+{
+    ensureManagerCreated();
+    return m_storage.localData()->sharedBackend(name);
+}
+
 Solid::DeviceNotifier *Solid::DeviceManagerStorage::notifier()
 {
     ensureManagerCreated();
@@ -10,11 +10,15 @@
 #include "managerbase_p.h"
 
 #include "devicenotifier.h"
+#include "mountpointtrie_p.h"
 
 #include <QHash>
 #include <QPointer>
 #include <QSharedData>
 #include <QThreadStorage>
+#include <QTimer>
+
+#include <optional>
 
 namespace Solid
 {
@@ -33,25 +37,132 @@ public:
 
     DevicePrivate *findRegisteredDevice(const QString &udi);
 
+    /**
+     * Returns whether devicesOfType() may be used from the calling thread, the
+     * index is only maintained by the thread of this object.
+     */
+    bool isTypeIndexUsable() const;
+
+    /**
+     * Returns the UDIs of all the devices providing the given interface type,
+     * in the order of the backends, as the backends list them.
+     *
+     * They are served from an index maintained from the backends' notifications.
+     * Removed devices are dropped from it right away, the devices of a backend
+     * are only listed again after some of them appeared or changed. Changes to
+     * the backends shared by the process are seen before their notifications
+     * reach this thread.
+     */
+    QStringList devicesOfType(DeviceInterface::Type type);
+
+    /**
+     * Returns the UDIs of all the devices providing at least one of the given
+     * interface types, once each, ordered as devicesOfType() does.
+     */
+    QStringList devicesOfTypes(const QSet<DeviceInterface::Type> &types);
+
+    /**
+     * Returns the backend responsible for the given UDI, or nullptr if there is none.
+     */
+    Ifaces::DeviceManager *backendForUdi(const QString &udi);
+
+    /**
+     * Returns the UDI of the storage access whose mount point contains @p path,
+     * an empty string if no mount point contains it, or std::nullopt if one of
+     * the backends can't tell when its mount points change.
+     *
+     * Existing paths are resolved through the device number of the filesystem
+     * holding them, which sees through symlinks and bind mounts, and otherwise
+     * through their longest mount point prefix. Paths under a network share
+     * are resolved through their prefix alone, without touching the file
+     * system.
+     */
+    std::optional<QString> storageAccessUdiForPath(const QString &path);
+
+    /**
+     * Returns true while deviceRemoved() and deviceAdded() are emitted for a
+     * device whose interfaces changed, which deviceChanged() follows.
+     */
+    bool isReannouncing() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the interfaces of a known device changed, once its backend
+     * object has been refreshed.
+     */
+    void deviceChanged(const QString &udi);
+
+protected:
+    void backendLoaded(Ifaces::DeviceManager *backend) override;
+    void connectNotify(const QMetaMethod &signal) override;
+
 private Q_SLOTS:
     void _k_deviceAdded(const QString &udi);
     void _k_deviceRemoved(const QString &udi);
+    void _k_deviceChanged(const QString &udi);
     void _k_destroyed(QObject *object);
+    void _k_flushChanges();
 
 private:
     Ifaces::Device *createBackendObject(const QString &udi);
+    const QStringList &indexedDevices(Ifaces::DeviceManager *backend, DeviceInterface::Type type);
+    quint64 backendGeneration(Ifaces::DeviceManager *backend) const;
+    void unindexDevice(const QString &udi);
+
+    enum class Change {
+        Added,
+        Removed,
+        Modified,
+    };
+    void recordChange(const QString &udi, Change change);
+
+    void invalidateMountPoints(Ifaces::DeviceManager *backend);
 
     QExplicitlySharedDataPointer<DevicePrivate> m_nullDevice;
     QHash<QString, QPointer<DevicePrivate>> m_devicesMap;
     QHash<QObject *, QString> m_reverseMap;
+
+    struct TypeIndex {
+        // UDIs of the backend, in its order, listed at that generation of the backend
+        QStringList udis;
+        quint64 generation = 0;
+    };
+    // interface type -> backend -> UDIs providing it, each listed on first use
+    QHash<DeviceInterface::Type, QHash<Ifaces::DeviceManager *, TypeIndex>> m_typeIndex;
+    // bumped as devices of the backend appear or change
+    QHash<Ifaces::DeviceManager *, quint64> m_generations;
+
+    // changes pending for devicesChanged(), flushed when m_changesTimer fires
+    QHash<QString, Change> m_pendingChanges;
+    QTimer m_changesTimer;
+
+    // UDI -> mount point tables of the backends, refreshed lazily once stale
+    QHash<Ifaces::DeviceManager *, QHash<QString, QString>> m_mountPoints;
+    QHash<Ifaces::DeviceManager *, QHash<quint64, QString>> m_deviceNumbers;
+    QHash<Ifaces::DeviceManager *, QSet<QString>> m_networkShares;
+    QSet<Ifaces::DeviceManager *> m_staleMountPoints;
+    MountPointTrie m_mountPointTrie;
+    QHash<quint64, QString> m_deviceNumberIndex;
+    bool m_mountPointTrieValid = false;
+    bool m_reannouncing = false;
+
+    friend class DeviceNotifier;
 };
 
+/**
+ * The device manager of each thread using Solid, which keeps the Device
+ * objects of its thread. The backends shared by the process are reached
+ * through proxies, only the others are created again by each thread.
+ */
 class DeviceManagerStorage
 {
 public:
     DeviceManagerStorage();
 
     QList<Ifaces::DeviceManager *> managerBackends();
+    QList<Ifaces::DeviceManager *> managerBackends(const QSet<DeviceInterface::Type> &types);
+    QStringList backendNames(const QSet<DeviceInterface::Type> &types);
+    QFuture<Ifaces::DeviceManager *> sharedBackend(const QString &name);
     DeviceNotifier *notifier();
 
 private:
@@ -7,6 +7,7 @@
 #ifndef SOLID_DEVICENOTIFIER_H
 #define SOLID_DEVICENOTIFIER_H
 
+#include <QHash>
 #include <QObject>
 
 #include <solid/solid_export.h>
@@ -32,6 +33,36 @@ class SOLID_EXPORT DeviceNotifier : public QObject // krazy:exclude=dpointer (in
 public:
     static DeviceNotifier *instance();
 
+    /**
+     * Sets the time window during which device changes are collected before
+     * devicesChanged() gets emitted.
+     *
+     * @param msecs the window in milliseconds, 100 by default
+     * @see devicesChanged()
+     * @since 6.13
+     */
+    void setCoalescingInterval(int msecs);
+
+    /**
+     * Returns the time window during which device changes are collected before
+     * devicesChanged() gets emitted.
+     *
+     * @return the window in milliseconds
+     * @since 6.13
+     */
+    int coalescingInterval() const;
+
+    /**
+     * Returns how long each backend created so far took to construct, keyed
+     * by backend name. A backend is only created once the devices it provides
+     * are needed, and the backends which are needed together get created in
+     * parallel.
+     *
+     * @return the construction times in nanoseconds
+     * @since 6.13
+     */
+    QHash<QString, qint64> backendStartupTimes() const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when a new device appears in the underlying system.
@@ -43,9 +74,31 @@ Q_SIGNALS:
     /**
      * This signal is emitted when a device disappears from the underlying system.
      *
+     * A device whose set of interfaces changed is reported as removed and
+     * then added again, so that it gets evaluated anew.
+     *
      * @param udi the old device UDI
      */
     void deviceRemoved(const QString &udi);
+
+    /**
+     * This signal is emitted with the device changes collected during the
+     * coalescing interval, instead of reacting to each deviceAdded() and
+     * deviceRemoved() in turn.
+     *
+     * A device added and removed within the same interval is not reported at
+     * all, a device removed and added again is reported as modified, as is a
+     * device whose set of interfaces changed. The
+     * changes are only tracked while this signal is connected, deviceAdded()
+     * and deviceRemoved() keep being emitted for each change.
+     *
+     * @param added the UDIs of the devices which appeared
+     * @param removed the UDIs of the devices which disappeared
+     * @param modified the UDIs of the devices whose interfaces may have changed
+     * @see setCoalescingInterval()
+     * @since 6.13
+     */
+    void devicesChanged(const QStringList &added, const QStringList &removed, const QStringList &modified);
 };
 }
 
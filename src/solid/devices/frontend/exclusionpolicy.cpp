@@ -0,0 +1,125 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "exclusionpolicy.h"
+#include "exclusionpolicy_p.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+Q_GLOBAL_STATIC(Solid::ExclusionPolicyPrivate, globalExclusionPolicy)
+
+namespace
+{
+QList<QRegularExpression> compilePatterns(const QStringList &patterns, QRegularExpression::WildcardConversionOptions options)
+{
+    QList<QRegularExpression> expressions;
+    expressions.reserve(patterns.size());
+    for (const QString &pattern : patterns) {
+        expressions.append(QRegularExpression::fromWildcard(pattern, Qt::CaseSensitive, options));
+    }
+    return expressions;
+}
+
+bool matchesAny(const QList<QRegularExpression> &expressions, const QString &subject)
+{
+    return std::any_of(expressions.cbegin(), expressions.cend(), [&subject](const QRegularExpression &expression) {
+        return expression.match(subject).hasMatch();
+    });
+}
+}
+
+Solid::ExclusionPolicyPrivate::ExclusionPolicyPrivate()
+{
+    const QString excludedDevices = qEnvironmentVariable("SOLID_EXCLUDED_DEVICES");
+    m_excludedDevices = excludedDevices.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    m_excludedDeviceExpressions = compilePatterns(m_excludedDevices, QRegularExpression::DefaultWildcardConversion);
+}
+
+Solid::ExclusionPolicyPrivate *Solid::ExclusionPolicyPrivate::instance()
+{
+    return globalExclusionPolicy();
+}
+
+bool Solid::ExclusionPolicyPrivate::isActive() const
+{
+    QMutexLocker locker(&m_lock);
+    return !m_excludedDevices.isEmpty() || !m_loopBackingFiles.isEmpty();
+}
+
+bool Solid::ExclusionPolicyPrivate::isExcluded(const QString &deviceName, bool isLoop, const QString &backingFile) const
+{
+    QMutexLocker locker(&m_lock);
+    if (matchesAny(m_excludedDeviceExpressions, deviceName)) {
+        return true;
+    }
+
+    return isLoop && !m_loopBackingFiles.isEmpty() && !matchesAny(m_loopBackingFileExpressions, backingFile);
+}
+
+void Solid::ExclusionPolicyPrivate::setExcludedDevices(const QStringList &patterns)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_excludedDevices == patterns) {
+            return;
+        }
+        m_excludedDevices = patterns;
+        m_excludedDeviceExpressions = compilePatterns(patterns, QRegularExpression::DefaultWildcardConversion);
+    }
+
+    Q_EMIT changed();
+}
+
+QStringList Solid::ExclusionPolicyPrivate::excludedDevices() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_excludedDevices;
+}
+
+void Solid::ExclusionPolicyPrivate::setLoopBackingFiles(const QStringList &patterns)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_loopBackingFiles == patterns) {
+            return;
+        }
+        m_loopBackingFiles = patterns;
+        // "/home/*" is meant to cover the subdirectories as well
+        m_loopBackingFileExpressions = compilePatterns(patterns, QRegularExpression::NonPathWildcardConversion);
+    }
+
+    Q_EMIT changed();
+}
+
+QStringList Solid::ExclusionPolicyPrivate::loopBackingFiles() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_loopBackingFiles;
+}
+
+void Solid::ExclusionPolicy::setExcludedDevices(const QStringList &patterns)
+{
+    globalExclusionPolicy->setExcludedDevices(patterns);
+}
+
+QStringList Solid::ExclusionPolicy::excludedDevices()
+{
+    return globalExclusionPolicy->excludedDevices();
+}
+
+void Solid::ExclusionPolicy::setLoopBackingFiles(const QStringList &patterns)
+{
+    globalExclusionPolicy->setLoopBackingFiles(patterns);
+}
+
+QStringList Solid::ExclusionPolicy::loopBackingFiles()
+{
+    return globalExclusionPolicy->loopBackingFiles();
+}
+
+#include "moc_exclusionpolicy_p.cpp"
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_EXCLUSIONPOLICY_H
+#define SOLID_EXCLUSIONPOLICY_H
+
+#include <QStringList>
+
+#include <solid/solid_export.h>
+
+namespace Solid
+{
+/**
+ * @class Solid::ExclusionPolicy exclusionpolicy.h <Solid/ExclusionPolicy>
+ *
+ * This class controls which block devices the storage backends ignore.
+ *
+ * Ignored devices are left out before any object is created for them: they
+ * are neither listed nor announced, and cost no memory. This is meant for
+ * hosts with many devices nobody is interested in, e.g. the loop devices of
+ * snap packages.
+ *
+ * The policy is process-wide and can be changed at any time, devices then
+ * get added or removed accordingly. Its initial value can be set with the
+ * SOLID_EXCLUDED_DEVICES environment variable, a comma-separated list of
+ * device name patterns.
+ *
+ * Only the UDisks2 backend currently applies it.
+ *
+ * @since 6.13
+ */
+class SOLID_EXPORT ExclusionPolicy // krazy:exclude=dpointer (only static members)
+{
+public:
+    /**
+     * Sets the patterns of the names of the block devices to ignore.
+     *
+     * @param patterns wildcard patterns matched against the device names,
+     * as found in /dev, e.g. "ram*" or "zram*"
+     */
+    static void setExcludedDevices(const QStringList &patterns);
+
+    /**
+     * Returns the patterns of the names of the block devices to ignore.
+     */
+    static QStringList excludedDevices();
+
+    /**
+     * Restricts the loop devices to the ones whose backing file matches one
+     * of @p patterns, the other ones are ignored.
+     *
+     * For example, "/home/*" only keeps the disk images of the users.
+     *
+     * @param patterns wildcard patterns matched against the full path of the
+     * backing files, an empty list keeps every loop device
+     */
+    static void setLoopBackingFiles(const QStringList &patterns);
+
+    /**
+     * Returns the patterns the backing files of the loop devices must match.
+     */
+    static QStringList loopBackingFiles();
+};
+}
+
+#endif
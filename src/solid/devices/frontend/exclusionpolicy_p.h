@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_EXCLUSIONPOLICY_P_H
+#define SOLID_EXCLUSIONPOLICY_P_H
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace Solid
+{
+/**
+ * State of the ExclusionPolicy, consulted by the backends from any thread.
+ */
+class ExclusionPolicyPrivate : public QObject
+{
+    Q_OBJECT
+public:
+    ExclusionPolicyPrivate();
+
+    static ExclusionPolicyPrivate *instance();
+
+    /**
+     * Returns whether the policy can exclude anything at all, backends may
+     * skip gathering the data isExcluded() needs otherwise.
+     */
+    bool isActive() const;
+
+    /**
+     * Returns whether the block device @p deviceName is ignored.
+     *
+     * @param deviceName the name of the device, as found in /dev
+     * @param isLoop whether it is a loop device
+     * @param backingFile the backing file of the loop device
+     */
+    bool isExcluded(const QString &deviceName, bool isLoop, const QString &backingFile) const;
+
+    void setExcludedDevices(const QStringList &patterns);
+    QStringList excludedDevices() const;
+    void setLoopBackingFiles(const QStringList &patterns);
+    QStringList loopBackingFiles() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the policy changed, backends should then reevaluate
+     * the devices they know of.
+     */
+    void changed();
+
+private:
+    mutable QMutex m_lock;
+    QStringList m_excludedDevices;
+    QList<QRegularExpression> m_excludedDeviceExpressions;
+    QStringList m_loopBackingFiles;
+    QList<QRegularExpression> m_loopBackingFileExpressions;
+};
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "livequery.h"
+
+#include "device.h"
+#include "devicemanager_p.h"
+#include "devicenotifier.h"
+#include "genericinterface.h"
+#include "storageaccess.h"
+
+#include <QHash>
+#include <QSet>
+
+class Solid::LiveQuery::Private
+{
+public:
+    Private(LiveQuery *query, const Predicate &predicate);
+
+    void watch(const QString &udi);
+    void unwatch(const QString &udi);
+    void evaluate(const QString &udi);
+
+    LiveQuery *const q;
+    const Predicate predicate;
+    const QSet<DeviceInterface::Type> usedTypes;
+
+    // candidates, kept alive so that their change signals reach us
+    QHash<QString, Device> watched;
+    QSet<QString> matching;
+};
+
+Solid::LiveQuery::Private::Private(LiveQuery *query, const Predicate &predicate)
+    : q(query)
+    , predicate(predicate)
+    , usedTypes(predicate.isValid() ? predicate.usedTypes() : QSet<DeviceInterface::Type>())
+{
+}
+
+void Solid::LiveQuery::Private::watch(const QString &udi)
+{
+    Device device(udi);
+
+    bool isCandidate = false;
+    for (const auto &type : usedTypes) {
+        if (device.isDeviceInterface(type)) {
+            isCandidate = true;
+            break;
+        }
+    }
+
+    if (!isCandidate) {
+        unwatch(udi);
+        return;
+    }
+
+    watched.insert(udi, device);
+
+    // Interfaces get recreated when the backend reports a change, connect the current ones
+    if (auto generic = device.as<GenericInterface>()) {
+        QObject::disconnect(generic, nullptr, q, nullptr);
+        QObject::connect(generic, &GenericInterface::propertyChanged, q, [this, udi]() {
+            evaluate(udi);
+        });
+    }
+    if (auto access = device.as<StorageAccess>()) {
+        QObject::disconnect(access, nullptr, q, nullptr);
+        QObject::connect(access, &StorageAccess::accessibilityChanged, q, [this, udi]() {
+            evaluate(udi);
+        });
+    }
+}
+
+void Solid::LiveQuery::Private::unwatch(const QString &udi)
+{
+    watched.remove(udi);
+
+    if (matching.remove(udi)) {
+        Q_EMIT q->left(udi);
+    }
+}
+
+void Solid::LiveQuery::Private::evaluate(const QString &udi)
+{
+    const auto it = watched.constFind(udi);
+    const bool matches = it != watched.constEnd() && predicate.matches(it.value());
+
+    if (matches && !matching.contains(udi)) {
+        matching.insert(udi);
+        Q_EMIT q->entered(udi);
+    } else if (!matches && matching.remove(udi)) {
+        Q_EMIT q->left(udi);
+    }
+}
+
+Solid::LiveQuery::LiveQuery(const Predicate &predicate, QObject *parent)
+    : QObject(parent)
+    , d(new Private(this, predicate))
+{
+    for (const auto &type : d->usedTypes) {
+        const QList<Device> devices = Device::listFromType(type);
+        for (const Device &device : devices) {
+            if (!d->watched.contains(device.udi())) {
+                d->watch(device.udi());
+            }
+        }
+    }
+
+    for (auto it = d->watched.cbegin(); it != d->watched.cend(); ++it) {
+        if (d->predicate.matches(it.value())) {
+            d->matching.insert(it.key());
+        }
+    }
+
+    if (d->usedTypes.isEmpty()) {
+        return;
+    }
+
+    DeviceNotifier *notifier = DeviceNotifier::instance();
+    auto manager = static_cast<DeviceManagerPrivate *>(notifier);
+    // A device whose interfaces changed is handled once, on deviceChanged()
+    connect(notifier, &DeviceNotifier::deviceAdded, this, [this, manager](const QString &udi) {
+        if (!manager->isReannouncing()) {
+            d->watch(udi);
+            d->evaluate(udi);
+        }
+    });
+    connect(notifier, &DeviceNotifier::deviceRemoved, this, [this, manager](const QString &udi) {
+        if (!manager->isReannouncing()) {
+            d->unwatch(udi);
+        }
+    });
+    connect(manager, &DeviceManagerPrivate::deviceChanged, this, [this](const QString &udi) {
+        d->watch(udi);
+        d->evaluate(udi);
+    });
+}
+
+Solid::LiveQuery::~LiveQuery()
+{
+    delete d;
+}
+
+Solid::Predicate Solid::LiveQuery::predicate() const
+{
+    return d->predicate;
+}
+
+QStringList Solid::LiveQuery::matchingUdis() const
+{
+    QStringList udis(d->matching.cbegin(), d->matching.cend());
+    std::sort(udis.begin(), udis.end());
+    return udis;
+}
+
+#include "moc_livequery.cpp"
@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_LIVEQUERY_H
+#define SOLID_LIVEQUERY_H
+
+#include <QObject>
+#include <QStringList>
+
+#include <solid/solid_export.h>
+
+#include <solid/predicate.h>
+
+namespace Solid
+{
+/**
+ * @class Solid::LiveQuery livequery.h <Solid/LiveQuery>
+ *
+ * This class keeps track of the devices verifying a predicate.
+ *
+ * Instead of running Device::listFromQuery() again on every hardware change,
+ * a LiveQuery reports the devices entering and leaving the set of matching
+ * devices. When a device is added, removed or changes, only that device gets
+ * evaluated against the predicate again.
+ *
+ * The devices matching when the query is created are available through
+ * matchingUdis(), no entered() signal is emitted for them.
+ *
+ * @since 6.13
+ */
+class SOLID_EXPORT LiveQuery : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a live query for the given predicate.
+     *
+     * @param predicate the predicate the devices must verify
+     * @param parent the parent object
+     */
+    explicit LiveQuery(const Predicate &predicate, QObject *parent = nullptr);
+
+    /**
+     * Destroys the live query.
+     */
+    ~LiveQuery() override;
+
+    /**
+     * Retrieves the predicate the devices are evaluated against.
+     *
+     * @return the predicate of this query
+     */
+    Predicate predicate() const;
+
+    /**
+     * Retrieves the devices currently verifying the predicate.
+     *
+     * @return the UDIs of the matching devices
+     */
+    QStringList matchingUdis() const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when a device starts verifying the predicate,
+     * either because it appeared or because it changed.
+     *
+     * @param udi the UDI of the device
+     */
+    void entered(const QString &udi);
+
+    /**
+     * This signal is emitted when a device stops verifying the predicate,
+     * either because it disappeared or because it changed.
+     *
+     * @param udi the UDI of the device
+     */
+    void left(const QString &udi);
+
+private:
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
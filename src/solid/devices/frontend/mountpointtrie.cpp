@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "mountpointtrie_p.h"
+
+Solid::MountPointTrie::MountPointTrie()
+{
+    clear();
+}
+
+void Solid::MountPointTrie::insert(const QString &mountPoint, const QString &udi)
+{
+    if (!mountPoint.startsWith(QLatin1Char('/'))) {
+        return;
+    }
+
+    size_t current = 0;
+    for (const auto component : QStringView(mountPoint).tokenize(QLatin1Char('/'), Qt::SkipEmptyParts)) {
+        const QString key = component.toString();
+        const auto it = m_nodes[current].children.constFind(key);
+        if (it != m_nodes[current].children.constEnd()) {
+            current = it.value();
+        } else {
+            const size_t child = m_nodes.size();
+            m_nodes[current].children.insert(key, int(child));
+            m_nodes.emplace_back();
+            current = child;
+        }
+    }
+
+    if (m_nodes[current].udi.isEmpty()) {
+        m_nodes[current].udi = udi;
+    }
+}
+
+QString Solid::MountPointTrie::find(const QString &path) const
+{
+    if (!path.startsWith(QLatin1Char('/'))) {
+        return QString();
+    }
+
+    size_t current = 0;
+    QString match = m_nodes[current].udi;
+    for (const auto component : QStringView(path).tokenize(QLatin1Char('/'), Qt::SkipEmptyParts)) {
+        const auto it = m_nodes[current].children.constFind(component.toString());
+        if (it == m_nodes[current].children.constEnd()) {
+            break;
+        }
+
+        current = it.value();
+        if (!m_nodes[current].udi.isEmpty()) {
+            match = m_nodes[current].udi;
+        }
+    }
+
+    return match;
+}
+
+void Solid::MountPointTrie::clear()
+{
+    m_nodes.clear();
+    m_nodes.emplace_back();
+}
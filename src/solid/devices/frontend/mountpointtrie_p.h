@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_MOUNTPOINTTRIE_P_H
+#define SOLID_MOUNTPOINTTRIE_P_H
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+namespace Solid
+{
+/**
+ * Prefix tree of mount points, indexed by path component.
+ *
+ * Finding the mount point owning a path costs one hash lookup per component
+ * of the path, whatever the number of mount points.
+ */
+class MountPointTrie
+{
+public:
+    MountPointTrie();
+
+    /**
+     * Associates @p udi with @p mountPoint, unless another UDI was inserted
+     * for the same mount point already.
+     */
+    void insert(const QString &mountPoint, const QString &udi);
+
+    /**
+     * Returns the UDI associated with the longest mount point containing
+     * @p path, or an empty string if there is none.
+     */
+    QString find(const QString &path) const;
+
+    void clear();
+
+private:
+    struct Node {
+        QString udi;
+        QHash<QString, int> children;
+    };
+
+    // nodes refer to their children by index, the first node is the root "/"
+    std::vector<Node> m_nodes;
+};
+}
+
+#endif
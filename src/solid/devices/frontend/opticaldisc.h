@@ -140,6 +140,11 @@ public:
      * Retrieves the content types this disc contains (audio, video,
      * data...).
      *
+     * Finding the video content types means reading the disc, which is done
+     * in the background on first use. Until then only Audio and Data are
+     * reported, and the device emits GenericInterface::propertyChanged() for
+     * "availableContent" once the full set is known.
+     *
      * @return the flag set indicating the available contents
      * @see Solid::OpticalDisc::ContentType
      */
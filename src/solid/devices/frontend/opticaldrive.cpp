@@ -52,4 +52,10 @@ bool Solid::OpticalDrive::eject()
     return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), false, eject());
 }
 
+Solid::OpticalDrive::EjectLatency Solid::OpticalDrive::lastEjectLatency() const
+{
+    Q_D(const OpticalDrive);
+    return_SOLID_CALL(Ifaces::OpticalDrive *, d->backendObject(), EjectLatency(), lastEjectLatency());
+}
+
 #include "moc_opticaldrive.cpp"
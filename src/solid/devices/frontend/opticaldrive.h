@@ -87,6 +87,23 @@ public:
     Q_DECLARE_FLAGS(MediumTypes, MediumType)
     Q_FLAG(MediumTypes)
 
+    /**
+     * Where the time of an eject went, in milliseconds. Steps which didn't
+     * happen, or which the backend doesn't measure, are -1.
+     *
+     * @since 6.13
+     */
+    struct EjectLatency {
+        /// finding the mounted filesystems of the drive
+        qint64 lookup = -1;
+        /// unmounting them
+        qint64 unmount = -1;
+        /// the eject itself
+        qint64 eject = -1;
+        /// from the call to eject() to the completion of the eject
+        qint64 total = -1;
+    };
+
 private:
     /**
      * Creates a new OpticalDrive object.
@@ -152,6 +169,15 @@ public:
      */
     bool eject();
 
+    /**
+     * Retrieves where the time of the last eject of this drive requested
+     * through eject() went, once ejectDone() was emitted for it.
+     *
+     * @return the latency breakdown of the last eject
+     * @since 6.13
+     */
+    EjectLatency lastEjectLatency() const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the eject button is pressed
@@ -6,11 +6,15 @@
 
 #include "predicate.h"
 
+#include <QAtomicPointer>
 #include <QMetaEnum>
+#include <QMetaProperty>
 #include <QSequentialIterable>
 #include <QStringList>
 #include <solid/device.h>
 
+#include <memory>
+
 namespace Solid
 {
 class Predicate::Private
@@ -25,6 +29,30 @@ public:
     {
     }
 
+    ~Private()
+    {
+        delete compiled.loadRelaxed();
+    }
+
+    /**
+     * A PropertyCheck with the meta-property, enum value and expected
+     * QVariant resolved against the meta-object of the interface.
+     */
+    struct CompiledCheck {
+        const QMetaObject *metaObject = nullptr;
+        QMetaProperty metaProperty;
+        QVariant expected;
+        int expectedMask = 0;
+        bool expectedMaskValid = false;
+    };
+
+    CompiledCheck compileCheck(const QMetaObject *metaObject) const;
+    bool matchesCheck(const CompiledCheck &check, const DeviceInterface *iface) const;
+    void resetCompiled()
+    {
+        delete compiled.fetchAndStoreOrdered(nullptr);
+    }
+
     bool isValid;
     Type type;
 
@@ -35,9 +63,69 @@ public:
 
     Predicate *operand1;
     Predicate *operand2;
+
+    // All the devices of an interface type share the same frontend meta-object,
+    // so a check is compiled on first use and reused for every device after that
+    mutable QAtomicPointer<CompiledCheck> compiled;
 };
 }
 
+Solid::Predicate::Private::CompiledCheck Solid::Predicate::Private::compileCheck(const QMetaObject *metaObject) const
+{
+    CompiledCheck check;
+    check.metaObject = metaObject;
+
+    const int index = metaObject->indexOfProperty(property.toLatin1().constData());
+    const QMetaProperty metaProp = metaObject->property(index);
+    check.metaProperty = metaProp;
+    check.expected = value;
+
+    if (metaProp.isEnumType() && value.userType() == QMetaType::QString) {
+        QMetaEnum metaEnum = metaProp.enumerator();
+        int enumValue = metaEnum.keysToValue(value.toString().toLatin1().constData());
+        if (enumValue >= 0) { // No value found for these keys, resetting expected to invalid
+            check.expected = QVariant(metaProp.metaType(), &enumValue);
+        } else {
+            check.expected = QVariant();
+        }
+    } else if (metaProp.isEnumType() && value.userType() == QMetaType::Int) {
+        int expectedValue = value.toInt();
+        check.expected = QVariant(metaProp.metaType(), &expectedValue);
+    }
+
+    check.expectedMask = check.expected.toInt(&check.expectedMaskValid);
+
+    return check;
+}
+
+bool Solid::Predicate::Private::matchesCheck(const CompiledCheck &check, const DeviceInterface *iface) const
+{
+    const QVariant propertyValue = check.metaProperty.isReadable() ? check.metaProperty.read(iface) : QVariant();
+
+    if (compOperator == Mask) {
+        bool v_ok;
+        int v = propertyValue.toInt(&v_ok);
+
+        return (check.expectedMaskValid && v_ok && (v & check.expectedMask));
+    }
+
+    if (propertyValue == check.expected) {
+        return true;
+    }
+
+    // Make sure we can match single elements inside lists.
+    if (propertyValue.canConvert<QSequentialIterable>()) {
+        const auto iterable = propertyValue.value<QSequentialIterable>();
+        for (const auto &element : iterable) {
+            if (element == check.expected) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 Solid::Predicate::Predicate()
     : d(new Private())
 {
@@ -122,6 +210,8 @@ Solid::Predicate &Solid::Predicate::operator=(const Predicate &other)
         d->compOperator = other.d->compOperator;
     }
 
+    d->resetCompiled();
+
     return *this;
 }
 
@@ -181,46 +271,23 @@ bool Solid::Predicate::matches(const Device &device) const
         const DeviceInterface *iface = device.asDeviceInterface(d->ifaceType);
 
         if (iface != nullptr) {
-            const int index = iface->metaObject()->indexOfProperty(d->property.toLatin1().constData());
-            QMetaProperty metaProp = iface->metaObject()->property(index);
-            QVariant value = metaProp.isReadable() ? metaProp.read(iface) : QVariant();
-            QVariant expected = d->value;
-
-            if (metaProp.isEnumType() && expected.userType() == QMetaType::QString) {
-                QMetaEnum metaEnum = metaProp.enumerator();
-                int value = metaEnum.keysToValue(d->value.toString().toLatin1().constData());
-                if (value >= 0) { // No value found for these keys, resetting expected to invalid
-                    expected = QVariant(metaProp.metaType(), &value);
-                } else {
-                    expected = QVariant();
-                }
-            } else if (metaProp.isEnumType() && expected.userType() == QMetaType::Int) {
-                int expectedValue = expected.toInt();
-                expected = QVariant(metaProp.metaType(), &expectedValue);
-            }
-
-            if (d->compOperator == Mask) {
-                bool v_ok;
-                int v = value.toInt(&v_ok);
-                bool e_ok;
-                int e = expected.toInt(&e_ok);
+            const QMetaObject *metaObject = iface->metaObject();
+            const Private::CompiledCheck *check = d->compiled.loadAcquire();
 
-                return (e_ok && v_ok && (v & e));
+            if (!check) {
+                auto compiled = std::make_unique<Private::CompiledCheck>(d->compileCheck(metaObject));
+                if (d->compiled.testAndSetOrdered(nullptr, compiled.get())) {
+                    compiled.release();
+                }
+                check = d->compiled.loadAcquire();
             }
 
-            if (value == expected) {
-                return true;
+            if (check->metaObject != metaObject) {
+                // Not the meta-object the check was compiled for, resolve it on the spot
+                return d->matchesCheck(d->compileCheck(metaObject), iface);
             }
 
-            // Make sure we can match single elements inside lists.
-            if (value.canConvert<QSequentialIterable>()) {
-                const auto iterable = value.value<QSequentialIterable>();
-                for (const auto &element : iterable) {
-                    if (element == expected) {
-                        return true;
-                    }
-                }
-            }
+            return d->matchesCheck(*check, iface);
         }
         break;
     }
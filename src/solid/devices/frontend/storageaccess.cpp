@@ -7,6 +7,7 @@
 #include "storageaccess.h"
 #include "storageaccess_p.h"
 
+#include "device_p.h"
 #include "soliddefs_p.h"
 #include <solid/devices/ifaces/storageaccess.h>
 
@@ -24,6 +25,13 @@ Solid::StorageAccess::StorageAccess(QObject *backendObject)
     connect(backendObject, SIGNAL(checkDone(Solid::ErrorType, QVariant, QString)), this, SIGNAL(checkDone(Solid::ErrorType, QVariant, QString)));
     connect(backendObject, SIGNAL(repairRequested(QString)), this, SIGNAL(repairRequested(QString)));
     connect(backendObject, SIGNAL(repairDone(Solid::ErrorType, QVariant, QString)), this, SIGNAL(repairDone(Solid::ErrorType, QVariant, QString)));
+
+    connect(backendObject, SIGNAL(jobStarted(QString, QString)), this, SIGNAL(jobStarted(QString, QString)));
+    connect(backendObject,
+            SIGNAL(jobProgressChanged(double, qulonglong, QDateTime, qulonglong, QString)),
+            this,
+            SIGNAL(jobProgressChanged(double, qulonglong, QDateTime, qulonglong, QString)));
+    connect(backendObject, SIGNAL(jobFinished(bool, QString, QString)), this, SIGNAL(jobFinished(bool, QString, QString)));
 }
 
 Solid::StorageAccess::StorageAccess(StorageAccessPrivate &dd, QObject *backendObject)
@@ -46,6 +54,13 @@ Solid::StorageAccess::StorageAccess(StorageAccessPrivate &dd, QObject *backendOb
     connect(backendObject, SIGNAL(checkDone(Solid::ErrorType, QVariant, QString)), this, SIGNAL(checkDone(Solid::ErrorType, QVariant, QString)));
     connect(backendObject, SIGNAL(repairRequested(QString)), this, SIGNAL(repairRequested(QString)));
     connect(backendObject, SIGNAL(repairDone(Solid::ErrorType, QVariant, QString)), this, SIGNAL(repairDone(Solid::ErrorType, QVariant, QString)));
+
+    connect(backendObject, SIGNAL(jobStarted(QString, QString)), this, SIGNAL(jobStarted(QString, QString)));
+    connect(backendObject,
+            SIGNAL(jobProgressChanged(double, qulonglong, QDateTime, qulonglong, QString)),
+            this,
+            SIGNAL(jobProgressChanged(double, qulonglong, QDateTime, qulonglong, QString)));
+    connect(backendObject, SIGNAL(jobFinished(bool, QString, QString)), this, SIGNAL(jobFinished(bool, QString, QString)));
 }
 
 Solid::StorageAccess::~StorageAccess()
@@ -112,4 +127,88 @@ bool Solid::StorageAccess::repair()
     return_SOLID_CALL(Ifaces::StorageAccess *, d->backendObject(), false, repair());
 }
 
+qint64 Solid::StorageAccess::bytesTotal() const
+{
+    Q_D(const StorageAccess);
+    return d->usage(this).bytesTotal;
+}
+
+qint64 Solid::StorageAccess::bytesUsed() const
+{
+    Q_D(const StorageAccess);
+    return d->usage(this).bytesUsed;
+}
+
+qint64 Solid::StorageAccess::bytesFree() const
+{
+    Q_D(const StorageAccess);
+    return d->usage(this).bytesFree;
+}
+
+qint64 Solid::StorageAccess::inodesTotal() const
+{
+    Q_D(const StorageAccess);
+    return d->usage(this).inodesTotal;
+}
+
+qint64 Solid::StorageAccess::inodesFree() const
+{
+    Q_D(const StorageAccess);
+    return d->usage(this).inodesFree;
+}
+
+void Solid::StorageAccess::setUsageThresholds(const QList<int> &percentages)
+{
+    StorageUsageMonitor::instance()->setThresholds(percentages);
+}
+
+QList<int> Solid::StorageAccess::usageThresholds()
+{
+    return StorageUsageMonitor::instance()->thresholds();
+}
+
+Solid::StorageAccessPrivate::~StorageAccessPrivate()
+{
+    if (!watchedPath.isEmpty()) {
+        StorageUsageMonitor::instance()->unwatch(watchedPath);
+    }
+}
+
+Solid::StorageUsage Solid::StorageAccessPrivate::usage(const StorageAccess *q) const
+{
+    const QString path = q->isAccessible() ? q->filePath() : QString();
+    StorageUsageMonitor *monitor = StorageUsageMonitor::instance();
+
+    if (path != watchedPath) {
+        if (!watchedPath.isEmpty()) {
+            monitor->unwatch(watchedPath);
+        }
+        watchedPath = path;
+        if (!watchedPath.isEmpty()) {
+            monitor->watch(watchedPath);
+        }
+    }
+
+    if (!usageConnected) {
+        usageConnected = true;
+        auto access = const_cast<StorageAccess *>(q);
+        QObject::connect(monitor, &StorageUsageMonitor::usageChanged, access, [this, access](const QString &changedPath) {
+            if (changedPath == watchedPath && devicePrivate()) {
+                Q_EMIT access->usageChanged(devicePrivate()->udi());
+            }
+        });
+        // Follow the volume when it gets mounted elsewhere or unmounted
+        QObject::connect(access, &StorageAccess::accessibilityChanged, access, [this, access](bool accessible, const QString &udi) {
+            Q_UNUSED(accessible);
+            const QString previousPath = watchedPath;
+            usage(access);
+            if (watchedPath != previousPath) {
+                Q_EMIT access->usageChanged(udi);
+            }
+        });
+    }
+
+    return path.isEmpty() ? StorageUsage() : monitor->usage(path);
+}
+
 #include "moc_storageaccess.cpp"
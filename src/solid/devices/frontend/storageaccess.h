@@ -9,6 +9,7 @@
 
 #include <solid/solid_export.h>
 
+#include <QDateTime>
 #include <QVariant>
 #include <solid/deviceinterface.h>
 #include <solid/solidnamespace.h>
@@ -36,6 +37,7 @@ class SOLID_EXPORT StorageAccess : public DeviceInterface
     Q_PROPERTY(bool encrypted READ isEncrypted)
     Q_DECLARE_PRIVATE(StorageAccess)
     friend class Device;
+    friend class StorageAccessBatch;
 
 private:
     /**
@@ -149,6 +151,78 @@ public:
      */
     bool repair();
 
+    /**
+     * Retrieves the size of the filesystem.
+     *
+     * Usage figures are measured in the background while the volume is
+     * accessible, so that a dead network mount can't block the caller.
+     * The first call starts the measurements and returns -1, until the
+     * figures are known, which is signaled by usageChanged().
+     *
+     * @return the size of the filesystem in bytes, or -1 if unknown
+     * @see usageThresholds()
+     * @since 6.13
+     */
+    qint64 bytesTotal() const;
+
+    /**
+     * Retrieves the space in use on the filesystem.
+     *
+     * @return the number of bytes in use, or -1 if unknown
+     * @see bytesTotal()
+     * @since 6.13
+     */
+    qint64 bytesUsed() const;
+
+    /**
+     * Retrieves the free space on the filesystem, which the user can use.
+     * Space reserved for the superuser isn't counted.
+     *
+     * @return the number of bytes available, or -1 if unknown
+     * @see bytesTotal()
+     * @since 6.13
+     */
+    qint64 bytesFree() const;
+
+    /**
+     * Retrieves the number of inodes of the filesystem.
+     *
+     * @return the number of inodes, or -1 if unknown or if the
+     * filesystem has no fixed number of inodes
+     * @see bytesTotal()
+     * @since 6.13
+     */
+    qint64 inodesTotal() const;
+
+    /**
+     * Retrieves the number of free inodes of the filesystem.
+     *
+     * @return the number of free inodes, or -1 if unknown
+     * @see inodesTotal()
+     * @since 6.13
+     */
+    qint64 inodesFree() const;
+
+    /**
+     * Sets the usage thresholds, in percents of the space or inodes in use,
+     * whose crossing is signaled by usageChanged(). The default thresholds
+     * are 90, 95 and 99%.
+     *
+     * The thresholds apply to all of the volumes of the process.
+     *
+     * @since 6.13
+     */
+    static void setUsageThresholds(const QList<int> &percentages);
+
+    /**
+     * Retrieves the usage thresholds.
+     *
+     * @return the thresholds, in percents
+     * @see setUsageThresholds()
+     * @since 6.13
+     */
+    static QList<int> usageThresholds();
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the accessiblity of this device
@@ -243,6 +317,56 @@ Q_SIGNALS:
      */
     void repairDone(Solid::ErrorType error, QVariant errorData, const QString &udi);
 
+    /**
+     * This signal is emitted when a long-running job starts operating on
+     * this device, e.g. a check, a repair, an unmount syncing the device
+     * or an eject. The job might be started by another process.
+     *
+     * @param operation the backend's name of the operation, e.g. "filesystem-unmount"
+     * @param udi the UDI of the volume
+     *
+     * @since 6.13
+     */
+    void jobStarted(const QString &operation, const QString &udi);
+
+    /**
+     * This signal is emitted when a job running on this device makes progress.
+     *
+     * @param progress the fraction of the job done, between 0 and 1, or -1 if unknown
+     * @param rate the throughput of the job in bytes per second, 0 if unknown
+     * @param expectedEndTime when the job is expected to end, invalid if unknown
+     * @param bytes the number of bytes the job processes, 0 if unknown
+     * @param udi the UDI of the volume
+     *
+     * @since 6.13
+     */
+    void jobProgressChanged(double progress, qulonglong rate, const QDateTime &expectedEndTime, qulonglong bytes, const QString &udi);
+
+    /**
+     * This signal is emitted when a job running on this device is finished.
+     *
+     * @param success whether the job succeeded
+     * @param message the error message of a failed job
+     * @param udi the UDI of the volume
+     *
+     * @since 6.13
+     */
+    void jobFinished(bool success, const QString &message, const QString &udi);
+
+    /**
+     * This signal is emitted when the usage of the filesystem crosses
+     * one of the usage thresholds, or when it becomes known or unknown.
+     * Smaller changes aren't signaled.
+     *
+     * Only volumes whose usage was queried are measured.
+     *
+     * @param udi the UDI of the volume
+     * @see usageThresholds()
+     *
+     * @since 6.13
+     */
+    void usageChanged(const QString &udi);
+
 protected:
     /**
      * @internal
@@ -8,9 +8,12 @@
 #define SOLID_STORAGEACCESS_P_H
 
 #include "deviceinterface_p.h"
+#include "storageusagemonitor_p.h"
 
 namespace Solid
 {
+class StorageAccess;
+
 class StorageAccessPrivate : public DeviceInterfacePrivate
 {
 public:
@@ -18,6 +21,13 @@ public:
         : DeviceInterfacePrivate()
     {
     }
+    ~StorageAccessPrivate() override;
+
+    StorageUsage usage(const StorageAccess *q) const;
+
+    // mount point whose usage is measured for this volume
+    mutable QString watchedPath;
+    mutable bool usageConnected = false;
 };
 }
 
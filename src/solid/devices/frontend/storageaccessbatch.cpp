@@ -0,0 +1,229 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "storageaccessbatch.h"
+
+#include "device.h"
+#include "storageaccess.h"
+#include "storageaccess_p.h"
+
+#include <solid/devices/ifaces/storageaccess.h>
+
+#include <QHash>
+#include <QTimer>
+
+#include <algorithm>
+#include <utility>
+
+class Solid::StorageAccessBatch::Private
+{
+public:
+    Private(StorageAccessBatch *qq, Operation operation, const QStringList &udis)
+        : q(qq)
+        , operation(operation)
+        , udis(withoutDuplicates(udis))
+    {
+    }
+
+    static QStringList withoutDuplicates(QStringList udis);
+    static bool setupWithPassphrase(StorageAccess *access, const QString &passphrase);
+
+    void startNext();
+    void startOperation(const QString &udi);
+    void deviceDone(const QString &udi, Solid::ErrorType error, const QVariant &errorData);
+
+    StorageAccessBatch *const q;
+    const Operation operation;
+    const QStringList udis;
+    int maximumConcurrency = 4;
+    QString passphrase;
+    bool started = false;
+    bool starting = false;
+
+    // index in udis of the next device to start
+    qsizetype next = 0;
+    // devices whose operation is running, kept alive until it is done
+    QHash<QString, Solid::Device> running;
+    QHash<QString, std::pair<Solid::ErrorType, QVariant>> results;
+};
+
+void Solid::StorageAccessBatch::Private::startNext()
+{
+    // Backends may report completion from within setup()/teardown()
+    if (starting) {
+        return;
+    }
+
+    starting = true;
+    while (running.size() < maximumConcurrency && next < udis.size()) {
+        const QString udi = udis.at(next++);
+        if (!results.contains(udi) && !running.contains(udi)) {
+            startOperation(udi);
+        }
+    }
+    starting = false;
+
+    if (running.isEmpty() && next >= udis.size()) {
+        const bool failed = std::any_of(results.cbegin(), results.cend(), [](const std::pair<Solid::ErrorType, QVariant> &result) {
+            return result.first != Solid::NoError;
+        });
+        Q_EMIT q->finished(failed ? Solid::OperationFailed : Solid::NoError);
+    }
+}
+
+void Solid::StorageAccessBatch::Private::startOperation(const QString &udi)
+{
+    Solid::Device device(udi);
+    auto access = device.as<Solid::StorageAccess>();
+    if (!access) {
+        deviceDone(udi, Solid::InvalidOption, QStringLiteral("%1 is not a storage access device").arg(udi));
+        return;
+    }
+
+    const bool setup = operation == Operation::Setup;
+    if (access->isAccessible() == setup) {
+        deviceDone(udi, Solid::NoError, QVariant());
+        return;
+    }
+
+    // Backends report completion with setupDone()/teardownDone(), some of them
+    // only through the accessibility change
+    QObject::connect(access, setup ? &StorageAccess::setupDone : &StorageAccess::teardownDone, q, [this](Solid::ErrorType error, const QVariant &errorData, const QString &doneUdi) {
+        if (running.contains(doneUdi)) {
+            deviceDone(doneUdi, error, errorData);
+            startNext();
+        }
+    });
+    QObject::connect(access, &StorageAccess::accessibilityChanged, q, [this, setup](bool accessible, const QString &changedUdi) {
+        if (accessible == setup && running.contains(changedUdi)) {
+            deviceDone(changedUdi, Solid::NoError, QVariant());
+            startNext();
+        }
+    });
+
+    running.insert(udi, device);
+
+    bool attempted;
+    if (!setup) {
+        attempted = access->teardown();
+    } else if (passphrase.isEmpty()) {
+        attempted = access->setup();
+    } else {
+        attempted = setupWithPassphrase(access, passphrase);
+    }
+
+    if (!attempted && running.contains(udi)) {
+        deviceDone(udi, Solid::OperationFailed, QStringLiteral("%1 is busy or doesn't support the operation").arg(udi));
+    }
+}
+
+void Solid::StorageAccessBatch::Private::deviceDone(const QString &udi, Solid::ErrorType error, const QVariant &errorData)
+{
+    const Solid::Device device = running.take(udi);
+    if (auto access = device.as<Solid::StorageAccess>()) {
+        QObject::disconnect(access, nullptr, q, nullptr);
+    }
+
+    results.insert(udi, {error, errorData});
+    Q_EMIT q->deviceDone(udi, error, errorData);
+}
+
+QStringList Solid::StorageAccessBatch::Private::withoutDuplicates(QStringList udis)
+{
+    // isRunning() and finished() count the results against the UDIs
+    udis.removeDuplicates();
+    return udis;
+}
+
+bool Solid::StorageAccessBatch::Private::setupWithPassphrase(StorageAccess *access, const QString &passphrase)
+{
+    auto iface = qobject_cast<Ifaces::StorageAccess *>(access->d_func()->backendObject());
+    return iface && iface->setupWithPassphrase(passphrase);
+}
+
+Solid::StorageAccessBatch::StorageAccessBatch(Operation operation, const QStringList &udis, QObject *parent)
+    : QObject(parent)
+    , d(new Private(this, operation, udis))
+{
+}
+
+Solid::StorageAccessBatch::~StorageAccessBatch()
+{
+    for (auto it = d->running.cbegin(); it != d->running.cend(); ++it) {
+        if (auto access = it.value().as<Solid::StorageAccess>()) {
+            disconnect(access, nullptr, this, nullptr);
+        }
+    }
+    delete d;
+}
+
+Solid::StorageAccessBatch::Operation Solid::StorageAccessBatch::operation() const
+{
+    return d->operation;
+}
+
+QStringList Solid::StorageAccessBatch::udis() const
+{
+    return d->udis;
+}
+
+void Solid::StorageAccessBatch::setMaximumConcurrency(int maximum)
+{
+    d->maximumConcurrency = qMax(1, maximum);
+}
+
+int Solid::StorageAccessBatch::maximumConcurrency() const
+{
+    return d->maximumConcurrency;
+}
+
+void Solid::StorageAccessBatch::setPassphrase(const QString &passphrase)
+{
+    d->passphrase = passphrase;
+}
+
+bool Solid::StorageAccessBatch::start()
+{
+    if (d->started) {
+        return false;
+    }
+    d->started = true;
+
+    // Report even the devices done right away asynchronously, once the caller
+    // had a chance to connect
+    QTimer::singleShot(0, this, [this]() {
+        d->startNext();
+    });
+    return true;
+}
+
+bool Solid::StorageAccessBatch::isRunning() const
+{
+    return d->started && d->results.size() < d->udis.size();
+}
+
+Solid::ErrorType Solid::StorageAccessBatch::error(const QString &udi) const
+{
+    return d->results.value(udi, {Solid::NoError, QVariant()}).first;
+}
+
+QVariant Solid::StorageAccessBatch::errorData(const QString &udi) const
+{
+    return d->results.value(udi).second;
+}
+
+QStringList Solid::StorageAccessBatch::failedDevices() const
+{
+    QStringList failed;
+    for (const QString &udi : d->udis) {
+        if (error(udi) != Solid::NoError) {
+            failed.append(udi);
+        }
+    }
+    return failed;
+}
+
+#include "moc_storageaccessbatch.cpp"
@@ -0,0 +1,140 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_STORAGEACCESSBATCH_H
+#define SOLID_STORAGEACCESSBATCH_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+
+#include <solid/solid_export.h>
+#include <solid/solidnamespace.h>
+
+namespace Solid
+{
+/**
+ * @class Solid::StorageAccessBatch storageaccessbatch.h <Solid/StorageAccessBatch>
+ *
+ * This class mounts or unmounts a set of StorageAccess devices concurrently.
+ *
+ * Up to maximumConcurrency() operations run at the same time, the next
+ * device is started as soon as one is done. Once all of them are done,
+ * finished() is emitted and the outcome of each device can be queried.
+ *
+ * Encrypted containers can be unlocked with a single passphrase given
+ * with setPassphrase(), instead of asking the user once per container.
+ *
+ * @since 6.13
+ */
+class SOLID_EXPORT StorageAccessBatch : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * The operation applied to the devices.
+     */
+    enum class Operation {
+        Setup,
+        Teardown,
+    };
+    Q_ENUM(Operation)
+
+    /**
+     * Creates a batch applying @p operation to the devices identified by @p udis.
+     *
+     * Devices which are already in the requested state succeed right away,
+     * devices listed more than once are only handled once.
+     *
+     * @param operation the operation to apply
+     * @param udis the UDIs of StorageAccess devices
+     * @param parent the parent object
+     */
+    StorageAccessBatch(Operation operation, const QStringList &udis, QObject *parent = nullptr);
+    ~StorageAccessBatch() override;
+
+    /**
+     * Returns the operation applied to the devices.
+     */
+    Operation operation() const;
+
+    /**
+     * Returns the UDIs of the devices of the batch, without duplicates.
+     */
+    QStringList udis() const;
+
+    /**
+     * Sets how many operations may run at the same time, 4 by default.
+     * Only taken into account before start().
+     */
+    void setMaximumConcurrency(int maximum);
+
+    /**
+     * Returns how many operations may run at the same time.
+     */
+    int maximumConcurrency() const;
+
+    /**
+     * Sets the passphrase unlocking the encrypted containers of the batch.
+     *
+     * The same passphrase is used for every container, the user is asked
+     * for the passphrase of each container otherwise.
+     */
+    void setPassphrase(const QString &passphrase);
+
+    /**
+     * Starts the operations.
+     *
+     * @return false if the batch was started already, true otherwise
+     */
+    bool start();
+
+    /**
+     * Returns whether operations are still running.
+     */
+    bool isRunning() const;
+
+    /**
+     * Returns the result of the operation on the device @p udi, NoError
+     * until it is done.
+     */
+    Solid::ErrorType error(const QString &udi) const;
+
+    /**
+     * Returns the error details reported for the device @p udi, if any.
+     */
+    QVariant errorData(const QString &udi) const;
+
+    /**
+     * Returns the UDIs of the devices whose operation failed, in the order
+     * they were given.
+     */
+    QStringList failedDevices() const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when the operation on a device is done.
+     *
+     * @param udi the UDI of the device
+     * @param error the result of the operation, NoError on success
+     * @param errorData the error details, if any
+     */
+    void deviceDone(const QString &udi, Solid::ErrorType error, const QVariant &errorData);
+
+    /**
+     * This signal is emitted once the operations on all the devices are done.
+     *
+     * @param error NoError if all of them succeeded, OperationFailed otherwise
+     */
+    void finished(Solid::ErrorType error);
+
+private:
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
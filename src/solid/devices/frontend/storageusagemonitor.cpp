@@ -0,0 +1,303 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "storageusagemonitor_p.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+#if defined(Q_OS_UNIX)
+#include <sys/statvfs.h>
+#else
+#include <QStorageInfo>
+#endif
+
+namespace
+{
+// rounds get further apart while nothing changes, up to the maximum interval
+constexpr int s_minimumInterval = 5000;
+constexpr int s_maximumInterval = 60000;
+// how long a measurement may take before its path is considered stalled
+constexpr int s_timeout = 3000;
+constexpr int s_workers = 2;
+}
+
+Q_GLOBAL_STATIC(Solid::StorageUsageMonitor, globalStorageUsageMonitor)
+
+int Solid::StorageUsage::percentUsed() const
+{
+    int percent = -1;
+    if (bytesTotal > 0) {
+        percent = int(100.0 * bytesUsed / bytesTotal);
+    }
+    if (inodesTotal > 0) {
+        percent = std::max(percent, int(100.0 * (inodesTotal - inodesFree) / inodesTotal));
+    }
+    return percent;
+}
+
+Solid::StorageUsageMonitor *Solid::StorageUsageMonitor::instance()
+{
+    // Constructed by whichever thread needs it first, but handled in the main thread
+    static std::once_flag created;
+    std::call_once(created, []() {
+        StorageUsageMonitor *monitor = globalStorageUsageMonitor();
+        if (QCoreApplication::instance()) {
+            monitor->moveToThread(QCoreApplication::instance()->thread());
+        }
+    });
+    return globalStorageUsageMonitor();
+}
+
+Solid::StorageUsageMonitor::StorageUsageMonitor()
+    : m_thresholds({90, 95, 99})
+    , m_refreshTimer(new QTimer(this))
+    , m_interval(s_minimumInterval)
+    , m_pool(new QThreadPool)
+    , m_receiver(std::make_shared<Receiver>())
+{
+    m_receiver->monitor = this;
+    m_pool->setMaxThreadCount(s_workers);
+
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, &QTimer::timeout, this, &StorageUsageMonitor::refresh);
+}
+
+Solid::StorageUsageMonitor::~StorageUsageMonitor()
+{
+    {
+        QMutexLocker locker(&m_receiver->lock);
+        m_receiver->monitor = nullptr;
+    }
+
+    // Deleting the pool waits for its threads, which could be stuck on a dead
+    // mount forever. Leave the pool behind then, rather than hanging.
+    if (m_pool->activeThreadCount() == 0) {
+        delete m_pool;
+    }
+}
+
+void Solid::StorageUsageMonitor::watch(const QString &path)
+{
+    QMutexLocker locker(&m_lock);
+    Entry &entry = m_entries[path];
+    if (entry.watchers++ > 0) {
+        return;
+    }
+    locker.unlock();
+
+    // Measure the new path right away, from the main thread
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            m_changed = true;
+            refresh();
+        },
+        Qt::QueuedConnection);
+}
+
+void Solid::StorageUsageMonitor::unwatch(const QString &path)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || --it->watchers > 0) {
+        return;
+    }
+
+    // An entry still measured is dropped once the measurement returns,
+    // forget its usage in case it gets watched again meanwhile
+    if (it->inFlight) {
+        it->usage = StorageUsage();
+        it->level = -1;
+    } else {
+        m_entries.erase(it);
+    }
+}
+
+Solid::StorageUsage Solid::StorageUsageMonitor::usage(const QString &path) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_entries.value(path).usage;
+}
+
+void Solid::StorageUsageMonitor::setThresholds(const QList<int> &percentages)
+{
+    QList<int> thresholds = percentages;
+    std::sort(thresholds.begin(), thresholds.end());
+
+    QMutexLocker locker(&m_lock);
+    m_thresholds = thresholds;
+    // The new levels are noticed, and signaled, by the next round
+    for (Entry &entry : m_entries) {
+        if (entry.level >= 0) {
+            entry.level = -2;
+        }
+    }
+}
+
+QList<int> Solid::StorageUsageMonitor::thresholds() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_thresholds;
+}
+
+Solid::StorageUsage Solid::StorageUsageMonitor::measure(const QString &path)
+{
+    StorageUsage usage;
+
+#if defined(Q_OS_UNIX)
+    struct statvfs info;
+    if (::statvfs(QFile::encodeName(path).constData(), &info) == 0 && info.f_blocks > 0) {
+        const qint64 blockSize = info.f_frsize ? info.f_frsize : info.f_bsize;
+        usage.bytesTotal = qint64(info.f_blocks) * blockSize;
+        usage.bytesUsed = qint64(info.f_blocks - info.f_bfree) * blockSize;
+        usage.bytesFree = qint64(info.f_bavail) * blockSize;
+        // Some filesystems, like btrfs, have no fixed number of inodes
+        if (info.f_files > 0) {
+            usage.inodesTotal = info.f_files;
+            usage.inodesFree = info.f_ffree;
+        }
+    }
+#else
+    const QStorageInfo info(path);
+    if (info.isValid() && info.isReady()) {
+        usage.bytesTotal = info.bytesTotal();
+        usage.bytesUsed = info.bytesTotal() - info.bytesFree();
+        usage.bytesFree = info.bytesAvailable();
+    }
+#endif
+
+    return usage;
+}
+
+void Solid::StorageUsageMonitor::refresh()
+{
+    checkDeadlines();
+
+    QStringList paths;
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (!it->inFlight) {
+                it->inFlight = true;
+                it->deadline.setRemainingTime(s_timeout);
+                paths.append(it.key());
+            }
+        }
+
+        if (m_entries.isEmpty()) {
+            return;
+        }
+    }
+
+    for (const QString &path : std::as_const(paths)) {
+        m_pool->start([receiver = m_receiver, path]() {
+            const StorageUsage usage = measure(path);
+
+            QMutexLocker locker(&receiver->lock);
+            if (StorageUsageMonitor *monitor = receiver->monitor) {
+                QMetaObject::invokeMethod(
+                    monitor,
+                    [monitor, path, usage]() {
+                        monitor->measured(path, usage);
+                    },
+                    Qt::QueuedConnection);
+            }
+        });
+    }
+
+    if (!paths.isEmpty()) {
+        QTimer::singleShot(s_timeout, this, &StorageUsageMonitor::checkDeadlines);
+    }
+
+    // Back off while the usage stays the same
+    m_interval = m_changed ? s_minimumInterval : std::min(2 * m_interval, s_maximumInterval);
+    m_changed = false;
+    m_refreshTimer->start(m_interval);
+}
+
+void Solid::StorageUsageMonitor::measured(const QString &path, const StorageUsage &usage)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    it->inFlight = false;
+    if (it->stalled) {
+        it->stalled = false;
+        m_pool->setMaxThreadCount(m_pool->maxThreadCount() - 1);
+    }
+
+    if (it->watchers == 0) {
+        m_entries.erase(it);
+        return;
+    }
+
+    // Anything above noise, 0.1% of the filesystem, keeps the rounds frequent
+    const StorageUsage previous = it->usage;
+    if (previous.isValid() != usage.isValid() || std::abs(previous.bytesUsed - usage.bytesUsed) > usage.bytesTotal / 1000
+        || std::abs(previous.inodesFree - usage.inodesFree) > usage.inodesTotal / 1000) {
+        m_changed = true;
+    }
+
+    it->usage = usage;
+    const int newLevel = level(usage);
+    if (newLevel == it->level) {
+        return;
+    }
+    it->level = newLevel;
+    locker.unlock();
+
+    Q_EMIT usageChanged(path);
+}
+
+void Solid::StorageUsageMonitor::checkDeadlines()
+{
+    QStringList stalled;
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->inFlight && !it->stalled && it->deadline.hasExpired()) {
+                // The worker stays blocked, make up for it
+                it->stalled = true;
+                m_pool->setMaxThreadCount(m_pool->maxThreadCount() + 1);
+
+                it->usage = StorageUsage();
+                if (it->level != -1) {
+                    it->level = -1;
+                    stalled.append(it.key());
+                }
+            }
+        }
+    }
+
+    for (const QString &path : std::as_const(stalled)) {
+        Q_EMIT usageChanged(path);
+    }
+}
+
+int Solid::StorageUsageMonitor::level(const StorageUsage &usage) const
+{
+    const int percent = usage.percentUsed();
+    if (percent < 0) {
+        return -1;
+    }
+
+    return int(std::count_if(m_thresholds.cbegin(), m_thresholds.cend(), [percent](int threshold) {
+        return percent >= threshold;
+    }));
+}
+
+#include "moc_storageusagemonitor_p.cpp"
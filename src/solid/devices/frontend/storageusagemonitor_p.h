@@ -0,0 +1,130 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_STORAGEUSAGEMONITOR_P_H
+#define SOLID_STORAGEUSAGEMONITOR_P_H
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+
+#include <memory>
+
+class QThreadPool;
+class QTimer;
+
+namespace Solid
+{
+/**
+ * Space and inode usage of a filesystem, -1 where unknown.
+ */
+struct StorageUsage {
+    qint64 bytesTotal = -1;
+    qint64 bytesUsed = -1;
+    // available to unprivileged users
+    qint64 bytesFree = -1;
+    qint64 inodesTotal = -1;
+    qint64 inodesFree = -1;
+
+    bool isValid() const
+    {
+        return bytesTotal >= 0;
+    }
+
+    // the higher percentage of space or inodes in use, -1 if unknown
+    int percentUsed() const;
+};
+
+/**
+ * Measures the usage of the filesystems mounted at the watched paths.
+ *
+ * All of the paths are measured in one round on worker threads, at an interval
+ * growing while their usage doesn't change. A measurement which doesn't return
+ * in time, e.g. on a dead network mount, makes the usage of its path unknown
+ * and leaves the path out of the following rounds until it returns.
+ *
+ * usageChanged() is only emitted when the usage of a path crosses one of the
+ * thresholds, or becomes known or unknown.
+ *
+ * There is one monitor per process, living in the main thread. Its methods
+ * are thread-safe.
+ */
+class StorageUsageMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StorageUsageMonitor *instance();
+
+    StorageUsageMonitor();
+    ~StorageUsageMonitor() override;
+
+    /**
+     * Starts measuring @p path. Calls are counted, each of them
+     * has to be balanced with a call to unwatch().
+     */
+    void watch(const QString &path);
+    void unwatch(const QString &path);
+
+    /**
+     * Returns the last usage measured for @p path.
+     */
+    StorageUsage usage(const QString &path) const;
+
+    void setThresholds(const QList<int> &percentages);
+    QList<int> thresholds() const;
+
+    /**
+     * Measures the filesystem at @p path, blocking until it answers.
+     */
+    static StorageUsage measure(const QString &path);
+
+Q_SIGNALS:
+    void usageChanged(const QString &path);
+
+private:
+    // the following are called in the main thread
+    void refresh();
+    void measured(const QString &path, const StorageUsage &usage);
+    void checkDeadlines();
+
+    // expects m_lock to be held by the caller
+    int level(const StorageUsage &usage) const;
+
+    struct Entry {
+        int watchers = 0;
+        StorageUsage usage;
+        // number of thresholds crossed, -1 while the usage is unknown,
+        // -2 until the next measurement after the thresholds changed
+        int level = -1;
+        bool inFlight = false;
+        bool stalled = false;
+        QDeadlineTimer deadline;
+    };
+
+    // lets workers outliving the monitor find out it is gone
+    struct Receiver {
+        QMutex lock;
+        StorageUsageMonitor *monitor;
+    };
+
+    // guards m_entries and m_thresholds
+    mutable QMutex m_lock;
+    QHash<QString, Entry> m_entries;
+    QList<int> m_thresholds;
+
+    QTimer *m_refreshTimer;
+    int m_interval;
+    // whether usage changed since the last round
+    bool m_changed = false;
+    QThreadPool *m_pool;
+    std::shared_ptr<Receiver> m_receiver;
+};
+}
+
+#endif
@@ -5,6 +5,11 @@
 */
 
 #include "ifaces/devicemanager.h"
+#include "ifaces/device.h"
+#include "ifaces/storageaccess.h"
+#include "ifaces/storagevolume.h"
+
+#include <memory>
 
 Solid::Ifaces::DeviceManager::DeviceManager(QObject *parent)
     : QObject(parent)
@@ -15,4 +20,97 @@ Solid::Ifaces::DeviceManager::~DeviceManager()
 {
 }
 
+bool Solid::Ifaces::DeviceManager::mightMatch(const QString &udi, const Solid::Predicate &predicate)
+{
+    return lowerPredicate(udi, predicate) != MatchResult::NoMatch;
+}
+
+bool Solid::Ifaces::DeviceManager::notifiesMountPointChanges() const
+{
+    return false;
+}
+
+QHash<QString, QString> Solid::Ifaces::DeviceManager::mountPoints()
+{
+    QHash<QString, QString> result;
+
+    const QStringList udis = devicesFromQuery(QString(), Solid::DeviceInterface::StorageAccess);
+    for (const QString &udi : udis) {
+        std::unique_ptr<QObject> object(createDevice(udi));
+        Ifaces::Device *device = qobject_cast<Ifaces::Device *>(object.get());
+        if (!device) {
+            continue;
+        }
+
+        if (device->queryDeviceInterface(Solid::DeviceInterface::StorageVolume)) {
+            auto volume = qobject_cast<Ifaces::StorageVolume *>(device->createDeviceInterface(Solid::DeviceInterface::StorageVolume));
+            if (volume && volume->usage() != Solid::StorageVolume::FileSystem) {
+                continue;
+            }
+        }
+
+        auto access = qobject_cast<Ifaces::StorageAccess *>(device->createDeviceInterface(Solid::DeviceInterface::StorageAccess));
+        if (!access) {
+            continue;
+        }
+
+        const QString filePath = access->filePath();
+        if (!filePath.isEmpty()) {
+            result.insert(udi, filePath);
+        }
+    }
+
+    return result;
+}
+
+QHash<quint64, QString> Solid::Ifaces::DeviceManager::deviceNumbers()
+{
+    return QHash<quint64, QString>();
+}
+
+Solid::Ifaces::DeviceManager::MatchResult Solid::Ifaces::DeviceManager::matchNatively(const QString &udi, const Solid::Predicate &check)
+{
+    Q_UNUSED(udi);
+    Q_UNUSED(check);
+    return MatchResult::Unknown;
+}
+
+// Three-valued evaluation of the predicate tree, the leaves being evaluated by the backend
+Solid::Ifaces::DeviceManager::MatchResult Solid::Ifaces::DeviceManager::lowerPredicate(const QString &udi, const Solid::Predicate &predicate)
+{
+    if (!predicate.isValid()) {
+        return MatchResult::NoMatch;
+    }
+
+    switch (predicate.type()) {
+    case Solid::Predicate::Conjunction: {
+        const MatchResult first = lowerPredicate(udi, predicate.firstOperand());
+        if (first == MatchResult::NoMatch) {
+            return MatchResult::NoMatch;
+        }
+        const MatchResult second = lowerPredicate(udi, predicate.secondOperand());
+        if (second == MatchResult::NoMatch) {
+            return MatchResult::NoMatch;
+        }
+        return (first == MatchResult::Match && second == MatchResult::Match) ? MatchResult::Match : MatchResult::Unknown;
+    }
+    case Solid::Predicate::Disjunction: {
+        const MatchResult first = lowerPredicate(udi, predicate.firstOperand());
+        if (first == MatchResult::Match) {
+            return MatchResult::Match;
+        }
+        const MatchResult second = lowerPredicate(udi, predicate.secondOperand());
+        if (second == MatchResult::Match) {
+            return MatchResult::Match;
+        }
+        return (first == MatchResult::NoMatch && second == MatchResult::NoMatch) ? MatchResult::NoMatch : MatchResult::Unknown;
+    }
+    case Solid::Predicate::PropertyCheck:
+    case Solid::Predicate::InterfaceCheck:
+        return matchNatively(udi, predicate);
+    }
+
+    return MatchResult::Unknown;
+}
+
 #include "moc_devicemanager.cpp"
@@ -7,11 +7,13 @@
 #ifndef SOLID_IFACES_DEVICEMANAGER_H
 #define SOLID_IFACES_DEVICEMANAGER_H
 
+#include <QHash>
 #include <QObject>
 
 #include <QStringList>
 
 #include <solid/deviceinterface.h>
+#include <solid/predicate.h>
 
 namespace Solid
 {
@@ -79,6 +81,80 @@ public:
      */
     virtual QObject *createDevice(const QString &udi) = 0;
 
+    /**
+     * Tells if a device may match a predicate, using only the data the backend
+     * has at hand. Devices for which this returns false are not instantiated
+     * by the frontend, the others are checked with Predicate::matches().
+     *
+     * The predicate is lowered into checks evaluated with matchNatively(),
+     * so this only returns false when the device can't possibly match.
+     *
+     * @param udi the identifier of the device to check
+     * @param predicate the predicate the device should match
+     * @returns false if the device can't match the predicate, true otherwise
+     */
+    bool mightMatch(const QString &udi, const Solid::Predicate &predicate);
+
+    /**
+     * Returns whether mountPointsChanged() is emitted each time the result
+     * of mountPoints() changes, the frontend only caches the mount points of
+     * such backends.
+     *
+     * @return true if mountPointsChanged() is reliable, false by default
+     */
+    virtual bool notifiesMountPointChanges() const;
+
+    /**
+     * Retrieves the mount point of each StorageAccess device, as reported by
+     * StorageAccess::filePath(). Devices which are a StorageVolume not used
+     * as a filesystem are skipped, as are devices without a mount point.
+     *
+     * The default implementation creates each StorageAccess device of the
+     * backend to query it.
+     *
+     * @return the mount points keyed by device UDI
+     */
+    virtual QHash<QString, QString> mountPoints();
+
+    /**
+     * Retrieves the device number of each mounted filesystem, as found in
+     * the st_dev field of the stat() of any file it contains, mapped to the
+     * UDI of the StorageAccess device mounting it.
+     *
+     * Like mountPoints(), this may only change when mountPointsChanged() is
+     * emitted. The default implementation returns an empty hash.
+     *
+     * @return the UDIs keyed by device number
+     */
+    virtual QHash<quint64, QString> deviceNumbers();
+
+protected:
+    /**
+     * The result of evaluating a predicate check in the backend.
+     */
+    enum class MatchResult {
+        NoMatch,
+        Match,
+        Unknown,
+    };
+
+    /**
+     * Evaluates a single PropertyCheck or InterfaceCheck predicate against
+     * the backend data of a device, without instantiating it.
+     *
+     * Backends should answer NoMatch or Match only when they are certain the
+     * frontend would reach the same result. The default implementation returns
+     * Unknown for every check.
+     *
+     * @param udi the identifier of the device to check
+     * @param check a predicate of type PropertyCheck or InterfaceCheck
+     * @returns the result of the check, or Unknown if it can't be evaluated natively
+     */
+    virtual MatchResult matchNatively(const QString &udi, const Solid::Predicate &check);
+
+private:
+    MatchResult lowerPredicate(const QString &udi, const Solid::Predicate &predicate);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when a new device appears in the system.
@@ -93,6 +169,20 @@ Q_SIGNALS:
      * @param udi the old device identifier
      */
     void deviceRemoved(const QString &udi);
+
+    /**
+     * This signal is emitted when the interfaces of a device changed, which
+     * may change whether it matches a predicate.
+     *
+     * @param udi the changed device identifier
+     */
+    void deviceChanged(const QString &udi);
+
+    /**
+     * This signal is emitted when the result of mountPoints() may have changed,
+     * by backends for which notifiesMountPointChanges() is true.
+     */
+    void mountPointsChanged();
 };
 }
 }
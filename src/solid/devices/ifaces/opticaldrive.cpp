@@ -9,3 +9,8 @@
 Solid::Ifaces::OpticalDrive::~OpticalDrive()
 {
 }
+
+Solid::OpticalDrive::EjectLatency Solid::Ifaces::OpticalDrive::lastEjectLatency() const
+{
+    return Solid::OpticalDrive::EjectLatency();
+}
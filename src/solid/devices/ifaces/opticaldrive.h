@@ -66,6 +66,14 @@ public:
      */
     virtual bool eject() = 0;
 
+    /**
+     * Retrieves where the time of the last eject of this drive went.
+     *
+     * @return the latency breakdown of the last eject, nothing measured by default
+     * @since 6.13
+     */
+    virtual Solid::OpticalDrive::EjectLatency lastEjectLatency() const;
+
 protected:
     // Q_SIGNALS:
     /**
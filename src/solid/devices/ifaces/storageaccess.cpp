@@ -10,6 +10,12 @@ Solid::Ifaces::StorageAccess::~StorageAccess()
 {
 }
 
+bool Solid::Ifaces::StorageAccess::setupWithPassphrase(const QString &passphrase)
+{
+    Q_UNUSED(passphrase);
+    return setup();
+}
+
 bool Solid::Ifaces::StorageAccess::canCheck() const
 {
     return false;
@@ -53,3 +59,25 @@ void Solid::Ifaces::StorageAccess::repairDone(Solid::ErrorType error, QVariant r
     Q_UNUSED(resultData);
     Q_UNUSED(udi);
 }
+
+void Solid::Ifaces::StorageAccess::jobStarted(const QString &operation, const QString &udi)
+{
+    Q_UNUSED(operation);
+    Q_UNUSED(udi);
+}
+
+void Solid::Ifaces::StorageAccess::jobProgressChanged(double progress, qulonglong rate, const QDateTime &expectedEndTime, qulonglong bytes, const QString &udi)
+{
+    Q_UNUSED(progress);
+    Q_UNUSED(rate);
+    Q_UNUSED(expectedEndTime);
+    Q_UNUSED(bytes);
+    Q_UNUSED(udi);
+}
+
+void Solid::Ifaces::StorageAccess::jobFinished(bool success, const QString &message, const QString &udi)
+{
+    Q_UNUSED(success);
+    Q_UNUSED(message);
+    Q_UNUSED(udi);
+}
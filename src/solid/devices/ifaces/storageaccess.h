@@ -68,6 +68,18 @@ public:
      */
     virtual bool setup() = 0;
 
+    /**
+     * Mounts the volume, unlocking it with @p passphrase first if it is an
+     * encrypted container instead of asking the user for one.
+     *
+     * The default implementation ignores the passphrase and calls setup().
+     *
+     * @param passphrase the passphrase of the encrypted container
+     * @return false if the operation is not supported, true if the
+     * operation is attempted
+     */
+    virtual bool setupWithPassphrase(const QString &passphrase);
+
     /**
      * Unmounts the volume.
      *
@@ -191,6 +203,35 @@ protected:
      * @param udi the UDI of the volume
      */
     virtual void repairDone(Solid::ErrorType error, QVariant resultData, const QString &udi);
+
+    /**
+     * This signal is emitted when a long-running job, like a check or an
+     * unmount syncing the device, starts operating on this device.
+     *
+     * @param operation the backend's name of the operation
+     * @param udi the UDI of the volume
+     */
+    virtual void jobStarted(const QString &operation, const QString &udi);
+
+    /**
+     * This signal is emitted when a job running on this device makes progress.
+     *
+     * @param progress the fraction of the job done, between 0 and 1, or -1 if unknown
+     * @param rate the throughput of the job in bytes per second, 0 if unknown
+     * @param expectedEndTime when the job is expected to end, invalid if unknown
+     * @param bytes the number of bytes the job processes, 0 if unknown
+     * @param udi the UDI of the volume
+     */
+    virtual void jobProgressChanged(double progress, qulonglong rate, const QDateTime &expectedEndTime, qulonglong bytes, const QString &udi);
+
+    /**
+     * This signal is emitted when a job running on this device is finished.
+     *
+     * @param success whether the job succeeded
+     * @param message the error message of a failed job
+     * @param udi the UDI of the volume
+     */
+    virtual void jobFinished(bool success, const QString &message, const QString &udi);
 };
 }
 }
@@ -5,6 +5,10 @@
 */
 
 #include "managerbase_p.h"
+#include "devices_debug.h"
+#include "sharedbackends_p.h"
+
+#include <QElapsedTimer>
 
 #include <stdlib.h>
 
@@ -43,49 +47,271 @@ Solid::ManagerBasePrivate::ManagerBasePrivate()
 
 Solid::ManagerBasePrivate::~ManagerBasePrivate()
 {
-    qDeleteAll(m_backends);
+    for (const Backend &backend : std::as_const(m_backends)) {
+        delete backend.instance;
+    }
 }
 
 // do *not* use other defines than BUILD_DEVICE_BACKEND_$backend to add
 // the managers, and keep an alphabetical order
+//
+// Backends registered with their interface types and UDI prefix, taken from
+// their static metadata, are only created once a query needs one of those
+// types or one of their devices. The others are created right away.
+//
+// The backends which only talk to system services and keep no thread-affine
+// state are shared by all threads, so that each thread doesn't enumerate the
+// devices and subscribe to their changes again. udev stays per thread, libudev
+// handles are not thread-safe, as does the fake backend the tests drive directly.
 void Solid::ManagerBasePrivate::loadBackends()
 {
     QString solidFakeXml(QString::fromLocal8Bit(qgetenv("SOLID_FAKEHW")));
 
     if (!solidFakeXml.isEmpty()) {
 #ifdef BUILD_DEVICE_BACKEND_fakehw
-        m_backends << new Solid::Backends::Fake::FakeManager(nullptr, solidFakeXml);
+        addBackend(QStringLiteral("fakehw"), QString(), {}, [solidFakeXml]() {
+            return new Solid::Backends::Fake::FakeManager(nullptr, solidFakeXml);
+        });
 #endif
     } else {
 #ifdef BUILD_DEVICE_BACKEND_fstab
-        m_backends << new Solid::Backends::Fstab::FstabManager(nullptr);
+        addBackend(
+            QStringLiteral("fstab"),
+            Solid::Backends::Fstab::FstabManager::staticUdiPrefix(),
+            Solid::Backends::Fstab::FstabManager::staticSupportedInterfaces(),
+            []() {
+                return new Solid::Backends::Fstab::FstabManager(nullptr);
+            },
+            Sharing::Process);
 #endif
 #ifdef BUILD_DEVICE_BACKEND_imobile
-        m_backends << new Solid::Backends::IMobile::Manager(nullptr);
+        addBackend(QStringLiteral("imobile"), QString(), {}, []() {
+            return new Solid::Backends::IMobile::Manager(nullptr);
+        });
 #endif
 #ifdef BUILD_DEVICE_BACKEND_iokit
-        m_backends << new Solid::Backends::IOKit::IOKitManager(nullptr);
+        addBackend(QStringLiteral("iokit"), QString(), {}, []() {
+            return new Solid::Backends::IOKit::IOKitManager(nullptr);
+        });
 #endif
 #ifdef BUILD_DEVICE_BACKEND_udev
-        m_backends << new Solid::Backends::UDev::UDevManager(nullptr);
+        addBackend(QStringLiteral("udev"),
+                   Solid::Backends::UDev::UDevManager::staticUdiPrefix(),
+                   Solid::Backends::UDev::UDevManager::staticSupportedInterfaces(),
+                   []() {
+                       return new Solid::Backends::UDev::UDevManager(nullptr);
+                   });
 #endif
 #ifdef BUILD_DEVICE_BACKEND_udisks2
         if (!qEnvironmentVariableIsSet("SOLID_DISABLE_UDISKS2")) {
-            m_backends << new Solid::Backends::UDisks2::Manager(nullptr);
+            addBackend(
+                QStringLiteral("udisks2"),
+                Solid::Backends::UDisks2::Manager::staticUdiPrefix(),
+                Solid::Backends::UDisks2::Manager::staticSupportedInterfaces(),
+                []() {
+                    return new Solid::Backends::UDisks2::Manager(nullptr);
+                },
+                Sharing::Process);
         }
 #endif
 #ifdef BUILD_DEVICE_BACKEND_upower
         if (!qEnvironmentVariableIsSet("SOLID_DISABLE_UPOWER")) {
-            m_backends << new Solid::Backends::UPower::UPowerManager(nullptr);
+            addBackend(
+                QStringLiteral("upower"),
+                Solid::Backends::UPower::UPowerManager::staticUdiPrefix(),
+                Solid::Backends::UPower::UPowerManager::staticSupportedInterfaces(),
+                []() {
+                    return new Solid::Backends::UPower::UPowerManager(nullptr);
+                },
+                Sharing::Process);
         }
 #endif
 #ifdef BUILD_DEVICE_BACKEND_win
-        m_backends << new Solid::Backends::Win::WinDeviceManager(nullptr);
+        addBackend(QStringLiteral("win"), QString(), {}, []() {
+            return new Solid::Backends::Win::WinDeviceManager(nullptr);
+        });
 #endif
     }
+
+    for (Backend &backend : m_backends) {
+        if (backend.types.isEmpty() || backend.udiPrefix.isEmpty()) {
+            load(backend);
+        }
+    }
 }
 
-QList<Solid::Ifaces::DeviceManager *> Solid::ManagerBasePrivate::managerBackends() const
+QList<Solid::Ifaces::DeviceManager *> Solid::ManagerBasePrivate::managerBackends()
 {
-    return m_backends;
+    QList<Backend *> backends;
+    backends.reserve(m_backends.size());
+
+    for (Backend &backend : m_backends) {
+        backends << &backend;
+    }
+    load(backends);
+
+    QList<Ifaces::DeviceManager *> result;
+    result.reserve(backends.size());
+    for (const Backend *backend : std::as_const(backends)) {
+        result << backend->instance;
+    }
+
+    return result;
+}
+
+QList<Solid::Ifaces::DeviceManager *> Solid::ManagerBasePrivate::managerBackends(const QSet<DeviceInterface::Type> &types)
+{
+    QList<Backend *> backends;
+
+    for (Backend &backend : m_backends) {
+        const auto supportedTypes = backend.instance ? backend.instance->supportedInterfaces() : backend.types;
+        if (supportedTypes.intersects(types)) {
+            backends << &backend;
+        }
+    }
+    load(backends);
+
+    QList<Ifaces::DeviceManager *> result;
+    result.reserve(backends.size());
+    for (const Backend *backend : std::as_const(backends)) {
+        result << backend->instance;
+    }
+
+    return result;
+}
+
+QStringList Solid::ManagerBasePrivate::backendNames(const QSet<DeviceInterface::Type> &types) const
+{
+    QStringList result;
+
+    for (const Backend &backend : m_backends) {
+        const auto supportedTypes = backend.instance ? backend.instance->supportedInterfaces() : backend.types;
+        if (types.isEmpty() || supportedTypes.intersects(types)) {
+            result << backend.name;
+        }
+    }
+
+    return result;
+}
+
+Solid::Ifaces::DeviceManager *Solid::ManagerBasePrivate::managerBackend(const QString &name)
+{
+    for (Backend &backend : m_backends) {
+        if (backend.name == name) {
+            return load(backend);
+        }
+    }
+
+    return nullptr;
+}
+
+QList<Solid::Ifaces::DeviceManager *> Solid::ManagerBasePrivate::loadedBackends() const
+{
+    QList<Ifaces::DeviceManager *> result;
+
+    for (const Backend &backend : m_backends) {
+        if (backend.instance) {
+            result << backend.instance;
+        }
+    }
+
+    return result;
+}
+
+Solid::Ifaces::DeviceManager *Solid::ManagerBasePrivate::managerBackendForUdi(const QString &udi)
+{
+    for (Backend &backend : m_backends) {
+        // backends without a known prefix are always loaded, ask them directly
+        const QString prefix = backend.instance ? backend.instance->udiPrefix() : backend.udiPrefix;
+        if (udi.startsWith(prefix)) {
+            return load(backend);
+        }
+    }
+
+    return nullptr;
+}
+
+QFuture<Solid::Ifaces::DeviceManager *> Solid::ManagerBasePrivate::sharedBackend(const QString &name) const
+{
+    for (const Backend &backend : m_backends) {
+        if (backend.name == name) {
+            return SharedBackends::instance()->backend(backend.name, backend.factory);
+        }
+    }
+
+    return QFuture<Ifaces::DeviceManager *>();
+}
+
+QHash<QString, qint64> Solid::ManagerBasePrivate::backendStartupTimes() const
+{
+    QHash<QString, qint64> result;
+
+    for (const Backend &backend : m_backends) {
+        if (backend.instance) {
+            const bool shared = backend.sharing == Sharing::Process;
+            result.insert(backend.name, shared ? SharedBackends::instance()->startupTime(backend.name) : backend.startupTime);
+        }
+    }
+
+    return result;
+}
+
+void Solid::ManagerBasePrivate::backendLoaded(Ifaces::DeviceManager *backend)
+{
+    Q_UNUSED(backend);
+}
+
+void Solid::ManagerBasePrivate::addBackend(const QString &name,
+                                           const QString &udiPrefix,
+                                           const QSet<DeviceInterface::Type> &types,
+                                           const std::function<Ifaces::DeviceManager *()> &factory,
+                                           Sharing sharing)
+{
+    Backend backend;
+    backend.name = name;
+    backend.udiPrefix = udiPrefix;
+    backend.types = types;
+    backend.factory = factory;
+    backend.sharing = sharing;
+    m_backends << backend;
+}
+
+// The shared backends are all set off in their own threads first, the others
+// then get created in this thread meanwhile, and the shared ones are waited for
+// in turn, so that independent backends initialise in parallel.
+void Solid::ManagerBasePrivate::load(const QList<Backend *> &backends)
+{
+    for (const Backend *backend : backends) {
+        if (!backend->instance && backend->sharing == Sharing::Process) {
+            SharedBackends::instance()->backend(backend->name, backend->factory);
+        }
+    }
+
+    for (Backend *backend : backends) {
+        load(*backend);
+    }
+}
+
+Solid::Ifaces::DeviceManager *Solid::ManagerBasePrivate::load(Backend &backend)
+{
+    if (backend.instance) {
+        return backend.instance;
+    }
+
+    if (backend.sharing == Sharing::Process) {
+        // Waits for the shared backend if another thread didn't create it already
+        Ifaces::DeviceManager *shared = SharedBackends::instance()->backend(backend.name, backend.factory).result();
+        backend.instance = new BackendProxy(shared);
+    } else {
+        QElapsedTimer timer;
+        timer.start();
+        backend.instance = backend.factory();
+        backend.startupTime = timer.nsecsElapsed();
+
+        qCDebug(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "Created backend" << backend.name << "in" << backend.startupTime / 1000 << "us";
+    }
+
+    backendLoaded(backend.instance);
+
+    return backend.instance;
 }
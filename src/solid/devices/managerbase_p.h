@@ -7,11 +7,18 @@
 #ifndef SOLID_MANAGERBASE_P_H
 #define SOLID_MANAGERBASE_P_H
 
+#include <QFuture>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 
 #include "ifaces/devicemanager.h"
 #include "solid/solid_export.h"
 
+#include <solid/deviceinterface.h>
+
+#include <functional>
+
 namespace Solid
 {
 class ManagerBasePrivate
@@ -21,10 +28,92 @@ public:
     virtual ~ManagerBasePrivate();
     void loadBackends();
 
-    QList<Ifaces::DeviceManager *> managerBackends() const;
+    /**
+     * Returns all the backends, creating the ones which were not needed so far.
+     */
+    QList<Ifaces::DeviceManager *> managerBackends();
+
+    /**
+     * Returns the backends which can provide devices of at least one of the
+     * given interface types, only those get created. An empty set matches
+     * none, use managerBackends() to get all of them.
+     */
+    QList<Ifaces::DeviceManager *> managerBackends(const QSet<DeviceInterface::Type> &types);
+
+    /**
+     * Returns the names of the backends which can provide devices of at least
+     * one of the given interface types, of all of them if @p types is empty,
+     * in registration order. None of them gets created.
+     */
+    QStringList backendNames(const QSet<DeviceInterface::Type> &types) const;
+
+    /**
+     * Returns the backend with the given name, creating only that one if
+     * needed, or nullptr if there is none.
+     */
+    Ifaces::DeviceManager *managerBackend(const QString &name);
+
+    /**
+     * Returns the backends created so far.
+     */
+    QList<Ifaces::DeviceManager *> loadedBackends() const;
+
+    /**
+     * Returns the backend responsible for the given UDI, creating it if needed,
+     * or nullptr if there is none.
+     */
+    Ifaces::DeviceManager *managerBackendForUdi(const QString &udi);
+
+    /**
+     * Returns the instance of the backend named @p name shared by the process,
+     * see SharedBackends, or a null future if there is no such backend. For
+     * the backends created per thread, that instance only serves the
+     * asynchronous queries.
+     */
+    QFuture<Ifaces::DeviceManager *> sharedBackend(const QString &name) const;
+
+    /**
+     * Returns the time in nanoseconds each backend created so far took to
+     * construct, keyed by backend name.
+     */
+    QHash<QString, qint64> backendStartupTimes() const;
+
+protected:
+    /**
+     * Called right after a backend got created, either from loadBackends()
+     * or on first use.
+     */
+    virtual void backendLoaded(Ifaces::DeviceManager *backend);
 
 private:
-    QList<Ifaces::DeviceManager *> m_backends;
+    enum class Sharing {
+        // each thread creates its own instance
+        PerThread,
+        // one instance serves every thread from a thread of its own, see SharedBackends
+        Process,
+    };
+
+    struct Backend {
+        QString name;
+        QString udiPrefix;
+        // interface types the backend can provide, empty if they are only known once it exists
+        QSet<DeviceInterface::Type> types;
+        std::function<Ifaces::DeviceManager *()> factory;
+        Sharing sharing = Sharing::PerThread;
+        // the backend itself, or a BackendProxy to the shared one
+        Ifaces::DeviceManager *instance = nullptr;
+        qint64 startupTime = -1;
+    };
+
+    void addBackend(const QString &name,
+                    const QString &udiPrefix,
+                    const QSet<DeviceInterface::Type> &types,
+                    const std::function<Ifaces::DeviceManager *()> &factory,
+                    Sharing sharing = Sharing::PerThread);
+    Ifaces::DeviceManager *load(Backend &backend);
+    void load(const QList<Backend *> &backends);
+
+    QList<Backend> m_backends;
 };
 }
 
@@ -0,0 +1,232 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "sharedbackends_p.h"
+#include "devices_debug.h"
+
+#include <QElapsedTimer>
+#include <QPromise>
+#include <QThread>
+
+#include <memory>
+
+Q_GLOBAL_STATIC(Solid::SharedBackends, globalSharedBackends)
+
+Solid::SharedBackends *Solid::SharedBackends::instance()
+{
+    return globalSharedBackends();
+}
+
+Solid::SharedBackends::SharedBackends()
+{
+}
+
+Solid::SharedBackends::~SharedBackends()
+{
+    // The backends and contexts get deleted by their thread as it finishes
+    for (const Home &home : std::as_const(m_homes)) {
+        home.thread->quit();
+        home.thread->wait();
+        delete home.thread;
+    }
+}
+
+QFuture<Solid::Ifaces::DeviceManager *> Solid::SharedBackends::backend(const QString &name, const std::function<Ifaces::DeviceManager *()> &factory)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const auto it = m_homes.constFind(name);
+    if (it != m_homes.constEnd()) {
+        return it->instance;
+    }
+
+    Home home;
+    home.thread = new QThread;
+    home.thread->setObjectName(QStringLiteral("Solid %1 backend").arg(name));
+    home.context = new QObject;
+    home.context->moveToThread(home.thread);
+    QObject::connect(home.thread, &QThread::finished, home.context, &QObject::deleteLater);
+
+    auto promise = std::make_shared<QPromise<Ifaces::DeviceManager *>>();
+    promise->start();
+    home.instance = promise->future();
+
+    QThread *thread = home.thread;
+    QMetaObject::invokeMethod(
+        home.context,
+        [this, name, factory, promise, thread]() {
+            QElapsedTimer timer;
+            timer.start();
+            Ifaces::DeviceManager *instance = factory();
+            const qint64 startupTime = timer.nsecsElapsed();
+
+            QObject::connect(thread, &QThread::finished, instance, &QObject::deleteLater);
+
+            {
+                QMutexLocker locker(&m_mutex);
+                m_homes[name].startupTime = startupTime;
+            }
+
+            qCDebug(Solid::Frontend::DeviceManager::DEVICEMANAGER) << "Created shared backend" << name << "in" << startupTime / 1000 << "us";
+
+            promise->addResult(instance);
+            promise->finish();
+        },
+        Qt::QueuedConnection);
+    home.thread->start();
+
+    m_homes.insert(name, home);
+    return home.instance;
+}
+
+QObject *Solid::SharedBackends::context(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_homes.value(name).context;
+}
+
+qint64 Solid::SharedBackends::startupTime(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_homes.value(name).startupTime;
+}
+
+template<typename Function>
+std::invoke_result_t<Function, Solid::Ifaces::DeviceManager *> Solid::BackendProxy::call(Function function) const
+{
+    using Result = std::invoke_result_t<Function, Ifaces::DeviceManager *>;
+
+    Ifaces::DeviceManager *backend = m_backend.data();
+    if (!backend) {
+        // the process is exiting
+        return Result();
+    }
+
+    if (backend->thread() == QThread::currentThread()) {
+        return function(backend);
+    }
+
+    Result result = Result();
+    QMetaObject::invokeMethod(
+        backend,
+        [&function, backend]() {
+            return function(backend);
+        },
+        Qt::BlockingQueuedConnection,
+        &result);
+    return result;
+}
+
+Solid::BackendProxy::BackendProxy(Ifaces::DeviceManager *backend, QObject *parent)
+    : Ifaces::DeviceManager(parent)
+    , m_backend(backend)
+    , m_generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    m_udiPrefix = call([](Ifaces::DeviceManager *backend) {
+        return backend->udiPrefix();
+    });
+    m_supportedInterfaces = call([](Ifaces::DeviceManager *backend) {
+        return backend->supportedInterfaces();
+    });
+    m_notifiesMountPointChanges = call([](Ifaces::DeviceManager *backend) {
+        return backend->notifiesMountPointChanges();
+    });
+
+    // Queued to the thread of the proxy
+    connect(backend, &Ifaces::DeviceManager::deviceAdded, this, &Ifaces::DeviceManager::deviceAdded);
+    connect(backend, &Ifaces::DeviceManager::deviceRemoved, this, &Ifaces::DeviceManager::deviceRemoved);
+    connect(backend, &Ifaces::DeviceManager::deviceChanged, this, &Ifaces::DeviceManager::deviceChanged);
+    connect(backend, &Ifaces::DeviceManager::mountPointsChanged, this, &Ifaces::DeviceManager::mountPointsChanged);
+
+    // Bumped right away in the thread of the backend
+    const auto generation = m_generation;
+    const auto bump = [generation]() {
+        ++*generation;
+    };
+    m_generationConnections << connect(backend, &Ifaces::DeviceManager::deviceAdded, bump);
+    m_generationConnections << connect(backend, &Ifaces::DeviceManager::deviceRemoved, bump);
+    m_generationConnections << connect(backend, &Ifaces::DeviceManager::deviceChanged, bump);
+}
+
+Solid::BackendProxy::~BackendProxy()
+{
+    for (const auto &connection : std::as_const(m_generationConnections)) {
+        disconnect(connection);
+    }
+}
+
+quint64 Solid::BackendProxy::generation() const
+{
+    return *m_generation;
+}
+
+QString Solid::BackendProxy::udiPrefix() const
+{
+    return m_udiPrefix;
+}
+
+QSet<Solid::DeviceInterface::Type> Solid::BackendProxy::supportedInterfaces() const
+{
+    return m_supportedInterfaces;
+}
+
+QStringList Solid::BackendProxy::allDevices()
+{
+    return call([](Ifaces::DeviceManager *backend) {
+        return backend->allDevices();
+    });
+}
+
+QStringList Solid::BackendProxy::devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type)
+{
+    return call([&parentUdi, type](Ifaces::DeviceManager *backend) {
+        return backend->devicesFromQuery(parentUdi, type);
+    });
+}
+
+QObject *Solid::BackendProxy::createDevice(const QString &udi)
+{
+    QThread *thread = QThread::currentThread();
+    return call([&udi, thread](Ifaces::DeviceManager *backend) {
+        QObject *device = backend->createDevice(udi);
+        // The frontend uses it from the calling thread, where it gets its signals
+        if (device) {
+            device->moveToThread(thread);
+        }
+        return device;
+    });
+}
+
+bool Solid::BackendProxy::notifiesMountPointChanges() const
+{
+    return m_notifiesMountPointChanges;
+}
+
+QHash<QString, QString> Solid::BackendProxy::mountPoints()
+{
+    return call([](Ifaces::DeviceManager *backend) {
+        return backend->mountPoints();
+    });
+}
+
+QHash<quint64, QString> Solid::BackendProxy::deviceNumbers()
+{
+    return call([](Ifaces::DeviceManager *backend) {
+        return backend->deviceNumbers();
+    });
+}
+
+Solid::Ifaces::DeviceManager::MatchResult Solid::BackendProxy::matchNatively(const QString &udi, const Solid::Predicate &check)
+{
+    // mightMatch() only tells whether the backend rules the check out, which is
+    // all that matters once the checks are combined
+    const bool mightMatch = call([&udi, &check](Ifaces::DeviceManager *backend) {
+        return backend->mightMatch(udi, check);
+    });
+    return mightMatch ? MatchResult::Unknown : MatchResult::NoMatch;
+}
+
+#include "moc_sharedbackends_p.cpp"
@@ -0,0 +1,123 @@
+/*
+    SPDX-FileCopyrightText: 2026 Solid Authors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef SOLID_SHAREDBACKENDS_P_H
+#define SOLID_SHAREDBACKENDS_P_H
+
+#include "ifaces/devicemanager.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+class QThread;
+
+namespace Solid
+{
+/**
+ * The backend instances shared by the whole process, one per backend name.
+ *
+ * Each one lives in a thread of its own, whose event loop keeps it current,
+ * and is created there on first use. They are destroyed in their thread when
+ * the process exits.
+ */
+class SharedBackends
+{
+public:
+    static SharedBackends *instance();
+
+    SharedBackends();
+    ~SharedBackends();
+
+    /**
+     * Returns the instance of the backend named @p name, which @p factory
+     * creates in the thread of the backend unless it exists already.
+     *
+     * Creating it is the first thing the thread of the backend does, so the
+     * future is always finished for the code running in that thread.
+     */
+    QFuture<Ifaces::DeviceManager *> backend(const QString &name, const std::function<Ifaces::DeviceManager *()> &factory);
+
+    /**
+     * Returns an object living in the thread of the backend named @p name,
+     * or nullptr if that backend wasn't asked for yet.
+     */
+    QObject *context(const QString &name) const;
+
+    /**
+     * Returns the time in nanoseconds the backend named @p name took to
+     * construct, or -1 if it wasn't created yet.
+     */
+    qint64 startupTime(const QString &name) const;
+
+private:
+    struct Home {
+        QThread *thread = nullptr;
+        QObject *context = nullptr;
+        QFuture<Ifaces::DeviceManager *> instance;
+        qint64 startupTime = -1;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, Home> m_homes;
+};
+
+/**
+ * Stands in a thread for a backend shared by the whole process.
+ *
+ * The calls are run by the backend in its own thread, the calling thread
+ * waiting for them, and the device objects the backend creates are handed
+ * over to the calling thread. The signals of the backend are queued to the
+ * thread of the proxy, so that each thread hears about the changes from its
+ * own event loop.
+ */
+class BackendProxy : public Ifaces::DeviceManager
+{
+    Q_OBJECT
+
+public:
+    explicit BackendProxy(Ifaces::DeviceManager *backend, QObject *parent = nullptr);
+    ~BackendProxy() override;
+
+    /**
+     * Returns a counter bumped by the backend as soon as it reports a change,
+     * before the notification reaches the thread of the proxy.
+     */
+    quint64 generation() const;
+
+    QString udiPrefix() const override;
+    QSet<Solid::DeviceInterface::Type> supportedInterfaces() const override;
+    QStringList allDevices() override;
+    QStringList devicesFromQuery(const QString &parentUdi, Solid::DeviceInterface::Type type = Solid::DeviceInterface::Unknown) override;
+    QObject *createDevice(const QString &udi) override;
+    bool notifiesMountPointChanges() const override;
+    QHash<QString, QString> mountPoints() override;
+    QHash<quint64, QString> deviceNumbers() override;
+
+protected:
+    MatchResult matchNatively(const QString &udi, const Solid::Predicate &check) override;
+
+private:
+    template<typename Function>
+    std::invoke_result_t<Function, Ifaces::DeviceManager *> call(Function function) const;
+
+    QPointer<Ifaces::DeviceManager> m_backend;
+    // constant once the backend exists, answered without a round-trip
+    QString m_udiPrefix;
+    QSet<Solid::DeviceInterface::Type> m_supportedInterfaces;
+    bool m_notifiesMountPointChanges = false;
+    std::shared_ptr<std::atomic<quint64>> m_generation;
+    QList<QMetaObject::Connection> m_generationConnections;
+};
+}
+
+#endif